@@ -4,6 +4,10 @@
 #include "webgpu-utils.h"
 #include "Camera.h"
 #include "SimulationConfig.h"
+#include "GpuProfiler.h"
+#include "Jonswap.h"
+#include "TuningCache.h"
+#include "SpectrumCache.h"
 #include "OceanSim.h"
 #include "Renderer.h"
 #include <GLFW/glfw3.h>
@@ -12,6 +16,7 @@
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_wgpu.h>
 #include <functional>
+#include <future>
 #include <iostream>
 #include <vector>
 
@@ -43,6 +48,9 @@ class Application
     wgpu::TextureFormat surface_format = wgpu::TextureFormat::Undefined;
 
     // --- subsystems ---
+    GpuProfiler profiler;
+    TuningCache tuning_cache;
+    SpectrumCache spectrum_cache{ "spectrum_cache" };
     OceanSim ocean;
     Renderer renderer;
 
@@ -55,6 +63,13 @@ class Application
     // --- current foam read index (set by ocean.tick each frame) ---
     int foam_idx = 0;
 
+    // --- last f16 vs f32 comparison (Ocean panel) ---
+    PrecisionReport precision_report;
+
+    // --- last scalar vs batched JONSWAP timing (Profiler panel), run on a worker ---
+    JonswapBenchmark jonswap_benchmark;
+    std::future<JonswapBenchmark> jonswap_run;   /* valid while a benchmark is in flight */
+
     // --- ImGui UI panels ---
     std::vector<std::function<void()>> ui_panels;
 
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "webgpu/webgpu.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* GPU timestamp profiler for compute passes. Each scope is one pass: hand the
+   writes returned by scope() to ComputePassDescriptor::timestampWrites, encode
+   resolve() after the last timed pass of the frame and call end_frame() once
+   it is submitted. Results come back asynchronously (one readback in flight;
+   frames encoded meanwhile are not timed) and are averaged per scope name.
+   Every call is a no-op when the device lacks FeatureName::TimestampQuery. */
+class GpuProfiler {
+public:
+    struct Timing {
+        std::string name;
+        double      avg_ms  = 0.0;   /* exponential moving average */
+        double      last_ms = 0.0;
+        uint64_t    samples = 0;
+    };
+
+    static constexpr uint32_t MAX_SCOPES = 16;
+
+    GpuProfiler() = default;
+    ~GpuProfiler();
+
+    void init(wgpu::Device device);
+    bool enabled() const { return active; }
+
+    /* Starts a new set of scopes. Call before the first timed pass of the frame. */
+    void begin_frame();
+
+    /* Timestamp writes for the next pass, or nullptr when nothing is being timed. */
+    const wgpu::ComputePassTimestampWrites* scope(const std::string& name);
+
+    void resolve(wgpu::CommandEncoder encoder);
+    void end_frame();
+
+    const std::vector<Timing>& timings() const { return results; }
+    void reset() { results.clear(); }
+
+private:
+    bool active    = false;
+    bool in_flight = false;   /* readback buffer is mapped or being mapped */
+    bool resolved  = false;   /* this frame's queries were copied to the readback buffer */
+
+    wgpu::QuerySet query_set;
+    wgpu::Buffer   resolve_buffer;
+    wgpu::Buffer   readback_buffer;
+    std::unique_ptr<wgpu::BufferMapCallback> map_callback;
+
+    std::array<wgpu::ComputePassTimestampWrites, MAX_SCOPES> writes;
+    std::vector<std::string> frame_names;     /* scopes encoded this frame */
+    std::vector<std::string> pending_names;   /* scopes of the readback in flight */
+    std::vector<Timing>      results;
+
+    void accumulate(const uint64_t* stamps);
+};
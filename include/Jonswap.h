@@ -0,0 +1,43 @@
+#pragma once
+
+#include "SimulationConfig.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/* The k-independent JONSWAP terms of an OceanConfig, evaluated once in double. */
+struct JonswapParams {
+    float peak_freq   = 0.f;   /* peak wavenumber */
+    float alpha       = 0.f;   /* energy scale */
+    float enhancement = 3.3f;  /* peak enhancement gamma */
+    float wind_dir[2] = {};    /* unit wind direction */
+
+    static JonswapParams from(const OceanConfig& ocean);
+};
+
+/* Reference JONSWAP spectrum S(k) of one wavevector, in double. */
+double jonswap(double pos_x, double pos_y,
+               double fetch, double wind_x, double wind_y,
+               double enhancement = 3.3);
+
+/* S(k) of n wavevectors: out[i] = jonswap(kx[i], ky[i], ...), in f32 with a polynomial
+   exp2, jonswap_lanes() at once (AVX-512, AVX2 + FMA or NEON when the build targets them,
+   a plain loop otherwise). Within about 1e-6 of the grid's peak S(k) of the reference.
+   `out` may alias kx or ky. */
+void jonswap_batch(const float* kx, const float* ky, float* out, size_t n, const JonswapParams& params);
+
+/* Instruction set jonswap_batch was compiled for, and its lane count. */
+const char* jonswap_isa();
+uint32_t    jonswap_lanes();
+
+/* jonswap vs jonswap_batch over one N × N cascade grid: best-of-several wall time of each
+   and the largest error of the batch relative to the grid's peak S(k). */
+struct JonswapBenchmark {
+    bool     valid     = false;
+    uint32_t size      = 0;
+    double   scalar_ms = 0.0;
+    double   batch_ms  = 0.0;
+    float    max_error = 0.f;
+};
+
+JonswapBenchmark benchmark_jonswap(const OceanConfig& ocean, uint32_t size, float patch_size);
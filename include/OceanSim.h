@@ -3,15 +3,63 @@
 #include "webgpu/webgpu.hpp"
 #include "SimulationConfig.h"
 #include "Pipelines.h"
+#include "ResourceManager.h"
 #include "Textures.h"
+#include "GpuProfiler.h"
+#include "SpectrumCache.h"
+#include "TuningCache.h"
 #include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
 
-/* Per-dispatch compute uniforms. Layout must match ComputeUniforms in fft.wgsl and time_spectrum.wgsl. */
+/* Packed IFFT channels, one texture-array layer each. Must match the LAYER_* constants in the shaders:
+   H + i·Dx, Sx + i·Sy, Dy + i·Jxy, and Jxx + i·Jyy only with FoamConfig::analytic_jacobian. */
+static constexpr uint32_t BASE_FFT_CHANNELS = 3;
+static constexpr uint32_t MAX_FFT_CHANNELS  = 4;
+
+/* Adapter feature behind the subgroup butterflies and the WGSL directive it enables.
+   Of the supported backends only Dawn exposes subgroups, behind its allow_unsafe_apis toggle
+   (see Application); elsewhere the path is compiled out. */
+#ifdef WEBGPU_BACKEND_DAWN
+static constexpr WGPUFeatureName SUBGROUP_FEATURE = WGPUFeatureName_ChromiumExperimentalSubgroups;
+static constexpr const char*     SUBGROUP_ENABLE  = "enable chromium_experimental_subgroups;\n";
+#endif
+
+/* Kernel families whose workgroup shape is autotuned (OceanSim::autotune):
+   timeSpectrum, the radix-2 stage kernels (incl. the fused stage 0) and the foam pass. */
+enum class TunedKernel : int {
+    Spectrum = 0,
+    FftStage = 1,
+    Foam     = 2,
+};
+static constexpr int TUNED_KERNELS = 3;
+
+/* What an OceanConfig edit invalidates, relative to the uploaded spectrum (see OceanSim::classify_change). */
+enum class SpectrumChange : int {
+    None       = 0,
+    Amplitude  = 1,   /* wave_amplitude only: h0 is linear in it, the kernels rescale it */
+    Regenerate = 2,   /* spectrum shape, patch geometry, pruning or ω grid: h0 is generated again */
+};
+
+/* Per-dispatch compute uniforms. Layout must match ComputeUniforms in spectrum_common.wgsl. */
 struct FourierUniforms {
-    float    time;
+    float    time;      /* frame time; the kernels evolve to cascade_time */
     uint32_t stage;
     uint32_t N;
     uint32_t log2n;
+    uint32_t ns;    /* Stockham stage chain: product of the radices of earlier stages */
+    uint32_t rows;  /* band pruning: occupied spectrum rows (N when off) */
+    float    dt;        /* incremental phase: seconds since the last frame (0 on a reseed); kernels use cascade_dt */
+    uint32_t halvings;  /* incremental phase: rotor angle halvings, see phase_rotor */
+    uint32_t phasor;    /* 1: advance the phasor buffer, 0: cos/sin of time */
+    uint32_t cascades;  /* channel blocks in the FFT arrays */
+    uint32_t active;    /* cascade decimation: bit c = cascade c is re-simulated this frame */
+    float    amplitude; /* wave_amplitude over the one h0 was generated with (see classify_change) */
+    float    cascade_time[MAX_CASCADES];   /* time each active cascade is evolved to */
+    float    cascade_dt[MAX_CASCADES];     /* incremental phase: seconds since its last update */
 };
 
 /* Per-frame foam compute uniforms. Layout must match FoamUniforms in foam.wgsl. */
@@ -21,7 +69,36 @@ struct FoamUniforms {
     float erosion;
     float fft_n;
     float foam_add;
-    float _pad0, _pad1, _pad2;
+    float texel_size;   /* patch_size / N: analytic Jacobian → per-texel units */
+    uint32_t cascades;
+    float _pad1;
+    float cascade_scale[MAX_CASCADES];   /* patch_size / cascade patch: cascade-0 uv → cascade uv */
+    float cascade_blend[MAX_CASCADES];   /* weight of the current layer, see OceanSim::schedule_cascades */
+};
+
+/* Spectrum generation uniforms (OceanConfig::gpu_spectrum). Layout must match
+   SpectrumUniforms in spectrum.wgsl. The k-independent JONSWAP terms are evaluated on the host. */
+struct SpectrumUniforms {
+    float    wind[2];        /* wind velocity, m/s */
+    float    peak_freq;      /* JONSWAP peak wavenumber */
+    float    alpha;          /* JONSWAP energy scale */
+    float    enhancement;    /* peak enhancement gamma */
+    float    omega_step;     /* looping mode: ω snapped to multiples of 2π / loop_period; 0 = off */
+    float    cutoff;         /* band pruning: fraction of peak |h0|² dropped; 0 = off */
+    uint32_t N;
+    float    patch[MAX_CASCADES];       /* patch width of each cascade, metres */
+    float    amplitude[MAX_CASCADES];   /* wave_amplitude with Δk relative to cascade 0 */
+    float    k_min[MAX_CASCADES];       /* energy band [k_min, k_max) of each cascade */
+    float    k_max[MAX_CASCADES];
+};
+
+/* f16 vs f32 comparison of the displacement texture, in its normalised units
+   (height and horizontal displacement before the renderer's patch scaling). */
+struct PrecisionReport {
+    bool  valid = false;
+    float max_abs[3] = {};   /* height, disp-x, disp-y */
+    float rms[3]     = {};
+    float rel_rms[3] = {};   /* rms error / rms of the f32 signal */
 };
 
 /* Owns all GPU compute resources: pipelines, ping-pong textures, uniform buffers,
@@ -30,23 +107,108 @@ class OceanSim {
     wgpu::Device device;
     wgpu::Queue  queue;
 
+    // --- simulation grid and precision (from config at the last init / rebuild) ---
+    uint32_t fft_size       = 0;
+    uint32_t fft_log        = 0;
+    bool     half           = false;   /* RGBA16Float h0, ping-pong and output textures */
+    bool     half_buffer    = false;   /* vec2<f16> storage buffer: half && shader-f16 */
+    bool     has_shader_f16 = false;   /* never on wgpu-native, which cannot compile `enable f16` */
+    bool     has_subgroups  = false;
+    bool     subgroups_failed = false;   /* set by init when the prologue disagrees with the plain chain */
+    bool     analytic_jacobian = false;   /* Jacobian channel transformed with the others */
+    uint32_t fft_channels   = BASE_FFT_CHANNELS;
+    uint32_t cascades       = 1;                   /* OceanConfig::cascades, clamped */
+    uint32_t fft_layers     = BASE_FFT_CHANNELS;   /* fft_channels × cascades: FFT array layers */
+    wgpu::TextureFormat storage_format = wgpu::TextureFormat::RGBA32Float;
+
+    OceanConfig spectrum_config;       /* the settings h0 was last generated from */
+    float       amplitude_scale = 1.f; /* FourierUniforms::amplitude */
+
     // --- compute pipelines ---
     wgpu::ComputePipeline time_spectrum_pipeline;
     wgpu::ComputePipeline fft_h_pipeline;
     wgpu::ComputePipeline fft_v_pipeline;
-    wgpu::ComputePipeline foam_pipeline;
+    wgpu::ComputePipeline fft_h_shared_pipeline;
+    wgpu::ComputePipeline fft_v_shared_pipeline;
+    wgpu::ComputePipeline foam_pipeline;            /* finite-difference Jacobian */
+    wgpu::ComputePipeline foam_spectral_pipeline;   /* analytic Jacobian channels */
+
+    /* Time evolution folded into the first horizontal pass (OceanConfig::fused_spectrum):
+       stage 0 of the radix-2 chain, or the whole row IFFT when shared_fft. */
+    wgpu::ComputePipeline fft_h_fused_pipeline;
+    wgpu::ComputePipeline fft_h_fused_shared_pipeline;
+
+    /* Stage-chain epilogue: fft[0] → displacement + slope textures. The single-dispatch
+       vertical kernel and the buffer backend's resolve write them directly. */
+    wgpu::ComputePipeline fft_resolve_pipeline;
+
+    /* Row-only pipeline (OceanConfig::transposed_vertical): tiled transpose between the two
+       horizontal passes, and a resolve that reads the transposed result. Uniform slots
+       [fft_log, 2·fft_log) repeat the stages with rows = N for the second horizontal pass. */
+    wgpu::ComputePipeline fft_transpose_pipeline;
+    wgpu::ComputePipeline fft_resolve_transposed_pipeline;
+    bool                  transposed_chain = false;   /* runs this frame */
+
+    /* Stockham radix-2/4/8 stage kernels, indexed by log2(radix) - 1. */
+    wgpu::ComputePipeline fft_h_radix_pipelines[3];
+    wgpu::ComputePipeline fft_v_radix_pipelines[3];
+
+    /* Subgroup prologue of the radix-2 chain (fft_subgroup.wgsl): the first
+       SUBGROUP_STAGES stages per direction in one dispatch. Only built with has_subgroups. */
+    static constexpr uint32_t SUBGROUP_STAGES = 5;
+    wgpu::ComputePipeline fft_h_subgroup_pipeline;
+    wgpu::ComputePipeline fft_v_subgroup_pipeline;
+    wgpu::ComputePipeline fft_h_fused_subgroup_pipeline;
+    bool                  subgroup_chain = false;   /* prologue runs this frame */
+
+    /* Four-step stage chain (OceanConfig::four_step): [horizontal, vertical][step one, two],
+       each FS_M-specialised to its sub-FFT length four_step_m[step] (N2 then N1, N = N1·N2). */
+    static constexpr uint32_t FOUR_STEP_LINES = 4;   /* sub-FFTs per workgroup, FS_LINES in fft.wgsl */
+    wgpu::ComputePipeline fft_four_step_pipelines[2][2];
+    uint32_t              four_step_m[2] = {};
+    bool                  four_step_chain = false;   /* runs this frame */
+
+    /* Radix of each Stockham stage this frame; empty when the DIT table kernels run. */
+    std::vector<uint32_t> stage_radices;
+
+    /* True when the adapter can hold a full FFT line in workgroup memory:
+       each direction is then a single dispatch instead of fft_log stages. Re-evaluated per N. */
+    bool shared_fft = false;
+
+    // --- storage-buffer backend (FftBackend::Buffer) ---
+    wgpu::ComputePipeline time_spectrum_buffer_pipeline;
+    wgpu::ComputePipeline fft_h_buffer_pipeline;
+    wgpu::ComputePipeline fft_v_buffer_pipeline;
+    wgpu::ComputePipeline fft_h_buffer_shared_pipeline;
+    wgpu::ComputePipeline fft_v_buffer_shared_pipeline;
+    wgpu::ComputePipeline resolve_buffer_pipeline;
+    wgpu::BindGroup       buffer_bind_group;
+    wgpu::BindGroupLayout buffer_bgl;
+    wgpu::PipelineLayout  buffer_layout;
+
+    // --- h0 generation (spectrum.wgsl, OceanConfig::gpu_spectrum): measure the peak for band
+    //     pruning, write h0 + k-data + the row mask, then list the occupied rows ---
+    wgpu::ComputePipeline h0_measure_pipeline;
+    wgpu::ComputePipeline h0_generate_pipeline;
+    wgpu::ComputePipeline h0_rows_pipeline;
+    wgpu::BindGroup       h0_bind_group;
+    wgpu::BindGroupLayout h0_bgl;
+    wgpu::PipelineLayout  h0_layout;
+    wgpu::Buffer          h0_uniform_buffer;
+    wgpu::Buffer          h0_stats_buffer;     /* peak |h0|² (f32 bits), occupied row count */
+    wgpu::Buffer          rows_readback_buffer;
+    std::unique_ptr<wgpu::BufferMapCallback> rows_callback;
+    bool                  rows_idle   = true;    /* no readback of the row count is mapped or being mapped */
+    bool                  rows_wanted = false;   /* the current spectrum's row count is still to be read back */
+    uint32_t              spectrum_uploads = 0;  /* apply_spectrum calls: older row counts are dropped */
 
     // --- time_spectrum bind group (static — no ping-pong needed) ---
     wgpu::BindGroup       time_spectrum_bind_group;
     wgpu::BindGroupLayout time_spectrum_bgl;
     wgpu::PipelineLayout  time_spectrum_layout;
 
-    // --- FFT bind groups (ping-pong pairs for 5 IFFT channels) ---
-    wgpu::BindGroup       h_fft_bind_groups[2];
-    wgpu::BindGroup       sx_fft_bind_groups[2];
-    wgpu::BindGroup       sy_fft_bind_groups[2];
-    wgpu::BindGroup       dx_fft_bind_groups[2];
-    wgpu::BindGroup       dy_fft_bind_groups[2];
+    // --- FFT bind groups (ping-pong pair; all channels travel together as array layers) ---
+    wgpu::BindGroup       fft_bind_groups[2];
     wgpu::BindGroupLayout fft_bgl;
     wgpu::PipelineLayout  fft_layout;
 
@@ -56,57 +218,247 @@ class OceanSim {
     wgpu::PipelineLayout  foam_layout;
     uint32_t              foam_frame = 0;
 
-    // --- simulation textures ---
-    wgpu::Texture     height_textures[2];
-    wgpu::TextureView height_texture_views[2];
-    wgpu::Texture     slope_x_textures[2];
-    wgpu::TextureView slope_x_texture_views[2];
-    wgpu::Texture     slope_y_textures[2];
-    wgpu::TextureView slope_y_texture_views[2];
-    wgpu::Texture     disp_x_textures[2];
-    wgpu::TextureView disp_x_texture_views[2];
-    wgpu::Texture     disp_y_textures[2];
-    wgpu::TextureView disp_y_texture_views[2];
+    // --- simulation textures (fft_layers layers, two real fields per layer: .r = re, .g = im;
+    //     h0, k-data and the outputs have one layer per cascade) ---
+    wgpu::Texture     fft_textures[2];
+    wgpu::TextureView fft_texture_views[2];
     wgpu::Texture     foam_textures[2];
     wgpu::TextureView foam_texture_views[2];
+    wgpu::TextureView foam_array_views[2];       /* one-layer arrays for the renderer, like loop_foam_view */
     wgpu::Texture     spectrum_texture;
     wgpu::TextureView spectrum_texture_view;
     wgpu::Texture     butterfly_texture;
     wgpu::TextureView butterfly_texture_view;
     wgpu::Texture     k_data_texture;
     wgpu::TextureView k_data_texture_view;
+    wgpu::Texture     noise_texture;               /* RG32Float: the Gaussian draws of h0 for noise_seed */
+    wgpu::TextureView noise_texture_view;
+    uint32_t          noise_seed = 0;
+    bool              noise_live = false;          /* noise_texture holds the draws of noise_seed */
+
+    // --- render-ready output (storage_format, filterable): written by the last FFT pass.
+    //     Layer c is cascade c's current result, layer cascades + c its previous one. ---
+    wgpu::Texture     displacement_texture;        /* dx, dy, h — normalised, before patch scaling */
+    wgpu::TextureView displacement_texture_view;
+    wgpu::Texture     slope_texture;               /* sx, sy */
+    wgpu::TextureView slope_texture_view;
+    wgpu::Sampler     surface_sampler;             /* foam pass: other cascades at cascade-0 texels */
+
+    /* Patch width of every cascade at the last spectrum upload, metres. */
+    float cascade_patch[MAX_CASCADES] = {};
+
+    /* The CPU side of a spectrum regeneration, made by build_spectrum off the render thread
+       and uploaded by apply_spectrum. */
+    struct SpectrumBuild : SpectrumData {
+        SimulationConfig config;                  /* the settings it was built from */
+        float            patch[MAX_CASCADES] = {};
+        double           k_min[MAX_CASCADES] = {};
+        double           k_max[MAX_CASCADES] = {};
+    };
+    std::future<SpectrumBuild> spectrum_build;   /* valid while a build is in flight or unapplied */
+
+    /* Spectra generated at startup or on a rebuild, for later launches with the same settings
+       (owned by Application; none for private probes, which neither read nor write files). */
+    const SpectrumCache* spectrum_cache = nullptr;
+
+    // --- fft_layers × N × N complex values for the buffer backend ---
+    wgpu::Buffer spectrum_buffer;
+    bool         buffer_fits = true;   /* false: above maxBufferSize, the texture backend runs instead */
+
+    // --- band pruning (see prune_bands): 2N u32, row mask then occupied row list ---
+    wgpu::Buffer prune_buffer;
+    uint32_t     live_rows = 0;       /* rows the pruned horizontal kernels visit */
+    bool         pruned    = false;   /* OceanConfig::band_pruning at the last upload */
+
+    // --- incremental phase (OceanConfig::incremental_phase): cascades × N × N vec2f e^{iωt}, advanced per frame ---
+    wgpu::Buffer       phasor_buffer;
+    std::vector<float> omegas;                /* ω per texel as in k_data, rebuilt by seed_phasors after an upload */
+    float              omega_max     = 0.0f;
+    double             last_time     = -1.0;  /* time of the previous tick, < 0 before the first */
+    bool               phasors_live  = false; /* phasor_buffer holds e^{iω·evolved_time[c]} per cascade */
+    bool               phasor_fits   = true;  /* false: above maxBufferSize, incremental phase is off */
+
+    // --- looping mode (OceanConfig::loop, see bake_loop): frame f of the period in layers
+    //     [f · cascades, (f + 1) · cascades) of disp / slope and layer f of foam ---
+    wgpu::Texture     loop_disp_texture;
+    wgpu::TextureView loop_disp_view;
+    wgpu::Texture     loop_slope_texture;
+    wgpu::TextureView loop_slope_view;
+    wgpu::Texture     loop_foam_texture;
+    wgpu::TextureView loop_foam_view;
+    float    quantised_period = 0.f;   /* ω grid of the uploaded spectrum, 2π / T; 0 = unquantised */
+    uint32_t loop_frames      = 0;
+    uint32_t loop_limit       = 0;     /* see loop_frame_limit */
+    uint64_t loop_frame_bytes = 0;
+    bool     loop_baked       = false;
+    bool     loop_playing     = false;
+    uint32_t loop_frame[2]    = {};    /* baked frames before and after the playback time */
+    float    loop_blend       = 1.0f;  /* weight of loop_frame[1] */
+    float    loop_amplitude   = 1.f;   /* amplitude_scale the loop was baked with */
+
+    // --- cascade decimation (OceanConfig::decimate_cascades, see schedule_cascades) ---
+    uint32_t intervals[MAX_CASCADES]     = {};   /* update interval in frames, 1 = every frame */
+    uint32_t phases[MAX_CASCADES]        = {};   /* update when (frame + phase) % interval == 0 */
+    double   evolved_time[MAX_CASCADES]  = {};   /* time of each cascade's current output layer */
+    double   previous_time[MAX_CASCADES] = {};   /* time of its previous output layer */
+    float    blend[MAX_CASCADES]         = {};   /* weight of the current layer this frame */
+    uint32_t active_mask    = 0;                 /* cascades re-simulated this frame */
+    uint64_t schedule_frame = 0;
+    bool     schedule_reset = true;              /* next frame updates every cascade at its own time */
+    float    update_rate    = 1.0f;              /* moving average of active cascades / cascades */
 
     // --- uniform buffers ---
     wgpu::Buffer compute_uniform_buffer;
     uint32_t     compute_uniform_stride = 0;
     wgpu::Buffer foam_uniform_buffer;
 
+    // --- optional pass timing (owned by Application) ---
+    GpuProfiler* profiler = nullptr;
+    std::string  fft_scope;   /* profiler scope of the FFT pass, names the variant */
+
+    // --- workgroup autotuning (cache owned by Application; none for private probes) ---
+    TuningCache*       tuning = nullptr;
+    WorkgroupShape     workgroups[TUNED_KERNELS];
+    bool               tuned[TUNED_KERNELS] = {};   /* shape came from the cache or a benchmark */
+    /* Source of each family, compiled once per shape with WG_X and WG_Y substituted. */
+    struct TunableSource {
+        std::vector<std::filesystem::path> paths;
+        ShaderVariant                      variant;
+    };
+    TunableSource      tunable_sources[TUNED_KERNELS];
+
+    void create_resources(const SimulationConfig& config);
+    void release_resources();
     void init_pipelines();
-    void init_textures(const SimulationConfig& config);
+    void init_textures();
     void init_buffers();
     void init_bind_groups();
     void upload_spectrum(const SimulationConfig& config);
+    void request_spectrum(const SimulationConfig& config);
+    static SpectrumBuild build_spectrum(const SimulationConfig& config, uint32_t size, uint32_t layers,
+                                        bool half, bool noise, const SpectrumCache* cache);
+    void apply_spectrum(const SpectrumBuild& build);
+    bool noise_stale(const OceanConfig& ocean) const;
+    void upload_noise(const std::vector<float>& noise, uint32_t seed);
+    void upload_cpu_spectrum(const SpectrumBuild& build);
+    void generate_gpu_spectrum(const SimulationConfig& config, const double* k_min, const double* k_max);
+    void read_row_count();
+
+    std::string tuning_key(int kernel) const;
+    void load_workgroups();
+    std::vector<wgpu::ComputePipeline> create_family(int kernel, WorkgroupShape shape);
+    void create_tuned_pipelines(int kernel);
+    void encode_family(wgpu::ComputePassEncoder pass, int kernel,
+                       const std::vector<wgpu::ComputePipeline>& pipelines, WorkgroupShape shape);
+    void autotune();
+    bool read_output(std::vector<float>& out);
+    bool verify_subgroups(const SimulationConfig& config);
+    void seed_phasors(double time);
+    int  simulate(double time, const SimulationConfig& config);
+    void bake_loop(const SimulationConfig& config);
+    void release_loop();
+    bool plan_cascades(const SimulationConfig& config);
+    void schedule_cascades(double time, double dt);
+    void encode_previous_copy(wgpu::CommandEncoder encoder);
+
+    wgpu::ComputePassEncoder begin_pass(wgpu::CommandEncoder encoder, const std::string& name);
+    void encode_texture_fft(wgpu::CommandEncoder encoder, bool single_dispatch, bool fused);
+    void encode_buffer_fft(wgpu::CommandEncoder encoder, bool single_dispatch);
+    void encode_columns_as_rows(wgpu::ComputePassEncoder pass, bool single_dispatch, int cur);
 
 public:
     OceanSim() = default;
     ~OceanSim();
 
-    /* Allocates all GPU resources. Call once after the device is created. */
-    void init(wgpu::Device d, wgpu::Queue q, const SimulationConfig& config);
+    /* Allocates all GPU resources. Call once after the device is created.
+       With a profiler, each compute pass (spectrum, FFT, foam) is timed as its own scope.
+       With a tuning cache, workgroup shapes come from it; shapes missing for this N are
+       benchmarked once (needs timestamp queries) and stored. With a spectrum cache, startup
+       and rebuilds reuse spectra generated by earlier runs. */
+    void init(wgpu::Device d, wgpu::Queue q, const SimulationConfig& config,
+              GpuProfiler* profiler = nullptr, TuningCache* tuning = nullptr,
+              const SpectrumCache* spectra = nullptr);
+
+    /* Rebuilds every N-, precision- and channel-dependent resource (textures, butterfly
+       table, FFT_N-specialised pipelines, bind groups) for config.ocean.fft_size,
+       half_precision, cascades and foam.analytic_jacobian. Resets foam; the renderer must rebuild its bind group afterwards.
+       Call between frames, never mid-encode. */
+    void rebuild(const SimulationConfig& config);
+
+    /* Bytes of the textures and buffers that grow with N² for `config` (fft_size, precision,
+       cascades, analytic Jacobian), counting the f32 buffer backend and the phasors whether
+       or not they fit the device. The caller keeps this within MAX_SIM_BYTES. */
+    static uint64_t resource_bytes(const SimulationConfig& config);
+
+    /* Dispatches one frame of compute work (time-spectrum + IFFT + foam) for the cascades
+       due this frame; decimated ones are evolved ahead to their next update (see
+       schedule_cascades) and blended by the renderer and foam pass in between. In looping
+       mode the period is baked on first use, after which a tick only picks the frames to show.
+       Returns the index of the foam texture just written — pass to Renderer::rebuild_bind_group.
+       `time` is seconds in double: the phasor path reseeds from it exactly, the classic path
+       rounds it to f32 on upload. */
+    int tick(double time, const SimulationConfig& config);
+
+    /* How `ocean` differs from the settings of the uploaded spectrum. tick applies an
+       Amplitude change as a uniform and regenerates h0 (same seed) on Regenerate, so UI
+       controls over the shape fields should commit once, not every drag frame. */
+    SpectrumChange classify_change(const OceanConfig& ocean) const;
+
+    /* A regenerated spectrum is still being built; the previous one is on screen. */
+    bool spectrum_pending() const { return spectrum_build.valid(); }
+
+    /* False when the single-dispatch FFT does not fit the adapter's workgroup limits. */
+    bool supports_single_dispatch() const { return shared_fft; }
+
+    uint32_t size() const { return fft_size; }
+    uint32_t cascade_count() const { return cascades; }
+    /* Cascade-0 patches per cascade-c patch: scales cascade-0 uv to cascade-c uv. */
+    float    cascade_uv_scale(uint32_t c) const { return cascade_patch[0] / cascade_patch[c]; }
+    WorkgroupShape workgroup(TunedKernel k) const { return workgroups[static_cast<int>(k)]; }
+    bool           workgroup_tuned(TunedKernel k) const { return tuned[static_cast<int>(k)]; }
+    bool     half_precision() const { return half; }
+    bool     has_analytic_jacobian() const { return analytic_jacobian; }
+    /* Current-layer weight of cascade c this frame (1 unless decimated or looping). */
+    float    cascade_blend(uint32_t c) const { return loop_playing ? loop_blend : blend[c]; }
+    /* First layer of the current (or previous) result of every cascade in displacement_view
+       and slope_view, and its layer in foam_view; see the cascade_blend weights. */
+    uint32_t surface_layer(bool previous) const
+    {
+        return loop_playing ? loop_frame[previous ? 0 : 1] * cascades : (previous ? cascades : 0);
+    }
+    uint32_t foam_layer(bool previous) const { return loop_playing ? loop_frame[previous ? 0 : 1] : 0; }
+    float    foam_blend() const { return loop_playing ? loop_blend : 1.0f; }
+    /* Drops the baked loop; the next tick bakes it again, e.g. after foam or frame count changes. */
+    void     rebake_loop() { release_loop(); }
+    /* Most loop frames that fit MAX_LOOP_BYTES and maxTextureArrayLayers at the current N,
+       cascade count and precision. Below 2 the loop is not baked and simulates live. */
+    uint32_t loop_frame_limit() const { return loop_limit; }
+    /* Fraction of the cascades re-simulated per frame, averaged; 1 without decimation. */
+    float    cascade_update_rate() const { return update_rate; }
+    bool     band_pruned() const { return pruned; }
+    uint32_t occupied_rows() const { return live_rows; }
+
+    /* The f16 storage buffer needs shader-f16; without it the buffer backend keeps f32
+       intermediates (its output texture is still RGBA16Float in half mode). */
+    bool supports_shader_f16() const { return has_shader_f16; }
+
+    /* False at resolutions whose spectrum buffer exceeds the device's maxBufferSize. */
+    bool supports_buffer_backend() const { return buffer_fits; }
+
+    /* False when the phasors of every cascade exceed the device's maxBufferSize. */
+    bool supports_incremental_phase() const { return phasor_fits; }
 
-    /* Dispatches one frame of compute work (time-spectrum + IFFT + foam).
-       Returns the index of the foam texture just written — pass to Renderer::rebuild_bind_group. */
-    int tick(float time, const SimulationConfig& config);
+    /* True when the device was created with the subgroup feature (Dawn only) and the
+       prologue matched the plain radix-2 chain at init. */
+    bool supports_subgroups() const { return has_subgroups; }
 
-    /* Re-generates h0(k) spectrum from config (wind, amplitude, fetch).
-       Call when any JONSWAP parameter changes. Does NOT advance the frame counter. */
-    void rebuild_spectrum(const SimulationConfig& config);
+    /* Runs the current spectrum at `time` once in f32 and once in f16 (same backend and
+       kernels as config) and compares the displacement output. Blocks on the readback. */
+    PrecisionReport compare_precision(const SimulationConfig& config, double time);
 
-    /* Texture view accessors for the Renderer to wire into its bind group. */
-    wgpu::TextureView height_view()          const { return height_texture_views[0]; }
-    wgpu::TextureView slope_x_view()         const { return slope_x_texture_views[0]; }
-    wgpu::TextureView slope_y_view()         const { return slope_y_texture_views[0]; }
-    wgpu::TextureView disp_x_view()          const { return disp_x_texture_views[0]; }
-    wgpu::TextureView disp_y_view()          const { return disp_y_texture_views[0]; }
-    wgpu::TextureView foam_view(int idx)     const { return foam_texture_views[idx]; }
+    /* Texture view accessors for the Renderer to wire into its bind group: the live output,
+       or the baked period while a loop plays. All of them are 2D arrays. */
+    wgpu::TextureView displacement_view()    const { return loop_playing ? loop_disp_view : displacement_texture_view; }
+    wgpu::TextureView slope_view()           const { return loop_playing ? loop_slope_view : slope_texture_view; }
+    wgpu::TextureView foam_view(int idx)     const { return loop_playing ? loop_foam_view : foam_array_views[idx]; }
 };
@@ -23,6 +23,23 @@ inline wgpu::BindGroupLayoutEntry uniform_layout(
     return e;
 }
 
+/* Storage buffer — read_write unless read_only is set. */
+inline wgpu::BindGroupLayoutEntry storage_buffer_layout(
+    uint32_t             binding,
+    WGPUShaderStageFlags visibility,
+    bool                 read_only = false,
+    uint64_t             min_size  = 0)
+{
+    wgpu::BindGroupLayoutEntry e    = wgpu::Default;
+    e.binding                       = binding;
+    e.visibility                    = visibility;
+    e.buffer.type                   = read_only ? wgpu::BufferBindingType::ReadOnlyStorage
+                                                : wgpu::BufferBindingType::Storage;
+    e.buffer.hasDynamicOffset       = false;
+    e.buffer.minBindingSize         = min_size;
+    return e;
+}
+
 /* Sampled (read-only) texture. */
 inline wgpu::BindGroupLayoutEntry texture_layout(
     uint32_t                   binding,
@@ -53,15 +70,16 @@ inline wgpu::BindGroupLayoutEntry sampler_layout(
 
 /* Write-only storage texture (used as compute output). */
 inline wgpu::BindGroupLayoutEntry storage_texture_layout(
-    uint32_t             binding,
-    WGPUShaderStageFlags visibility,
-    wgpu::TextureFormat  format = wgpu::TextureFormat::RGBA32Float)
+    uint32_t                   binding,
+    WGPUShaderStageFlags       visibility,
+    wgpu::TextureFormat        format = wgpu::TextureFormat::RGBA32Float,
+    wgpu::TextureViewDimension dim    = wgpu::TextureViewDimension::_2D)
 {
     wgpu::BindGroupLayoutEntry e       = wgpu::Default;
     e.binding                          = binding;
     e.visibility                       = visibility;
     e.storageTexture.access            = wgpu::StorageTextureAccess::WriteOnly;
-    e.storageTexture.viewDimension     = wgpu::TextureViewDimension::_2D;
+    e.storageTexture.viewDimension     = dim;
     e.storageTexture.format            = format;
     return e;
 }
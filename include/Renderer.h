@@ -21,8 +21,11 @@ struct RenderUniforms {
     float     N;
     float     patch_size;
     float     lambda;
-    float     _pad0;
-    float     _pad1;
+    uint32_t  cascades;
+    float     foam_blend;      /* OceanSim::foam_blend */
+    glm::vec4 cascade_scale;   /* per cascade: OceanSim::cascade_uv_scale */
+    glm::vec4 cascade_blend;   /* per cascade: OceanSim::cascade_blend */
+    glm::uvec4 layers;         /* OceanSim::surface_layer (current, previous), foam_layer (current, previous) */
 };
 
 /* Owns all render-side GPU resources: pipelines, geometry, cubemap, depth texture,
@@ -69,7 +72,7 @@ class Renderer {
     wgpu::Sampler sampler;
 
     void init_pipelines();
-    void init_geometry();
+    void init_geometry(uint32_t mesh_size);
     void init_depth();
     void init_foam_detail();
     void init_sampler();
@@ -83,6 +86,9 @@ public:
     void init(wgpu::Device d, wgpu::Queue q, wgpu::TextureFormat fmt,
               uint32_t w, uint32_t h, const SimulationConfig& config);
 
+    /* Recreates the size × size vertex grid, e.g. after the simulation resolution changed. */
+    void rebuild_mesh(uint32_t size);
+
     /* (Re)builds the render bind group pointing to the current OceanSim textures.
        foam_idx is the index of the foam texture most recently written by OceanSim::tick(). */
     void rebuild_bind_group(const OceanSim& ocean, int foam_idx);
@@ -3,8 +3,19 @@
 #include <vector>
 #include <cstdint>
 #include <filesystem>
+#include <string>
+#include <utility>
 #include <webgpu/webgpu.hpp>
 
+/* Source-level specialisation of a WGSL module: `prelude` is prepended (enable
+   directives, aliases) and every {from, to} pair is replaced throughout the source.
+   Used for what override constants cannot express, e.g. storage texel formats, and for
+   sizes, since wgpu-native 0.19 compiles no override constants at all. */
+struct ShaderVariant {
+    std::string                                      prelude;
+    std::vector<std::pair<std::string, std::string>> replacements;
+};
+
 /* Static utility class for loading files and GPU resources from disk. */
 class ResourceManager {
 public:
@@ -14,6 +25,18 @@ public:
         const std::filesystem::path& path,
         wgpu::Device device);
 
+    /* Concatenates several WGSL files in order and compiles them as one module, so helpers
+       shared between kernels can live in their own file. Returns nullptr on failure. */
+    static wgpu::ShaderModule load_shader_module(
+        const std::vector<std::filesystem::path>& paths,
+        wgpu::Device device);
+
+    /* As above, with the variant applied to the concatenated source before compiling. */
+    static wgpu::ShaderModule load_shader_module(
+        const std::vector<std::filesystem::path>& paths,
+        wgpu::Device device,
+        const ShaderVariant& variant);
+
     /* Loads a horizontal-cross cubemap PNG and extracts the six faces into facePixels.
        Faces are ordered in WebGPU layer order: +X(0), -X(1), +Y(2), -Y(3), +Z(4), -Z(5).
        The direction-to-face mapping for Z-up worlds is handled in the shaders.
@@ -30,4 +53,8 @@ public:
         std::vector<uint8_t>&        pixels,
         int&                         width,
         int&                         height);
+
+private:
+    static bool               read_text(const std::filesystem::path& path, std::string& out);
+    static wgpu::ShaderModule create_shader_module(const std::string& source, wgpu::Device device);
 };
@@ -3,12 +3,43 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <cstdint>
 
-/* Build-time constants — sizing GPU allocations. Changing these requires a full rebuild. */
-static constexpr uint32_t MESH_SIZE    = 256;
-static constexpr uint32_t TEXTURE_SIZE = 256;
-static constexpr uint32_t TEXTURE_LOG  = 8;  /* must equal log2(TEXTURE_SIZE) */
+/* Simulation resolution bounds. N (OceanConfig::fft_size) is chosen at runtime and must be
+   a power of two in this range; the mesh follows N up to MAX_MESH_SIZE vertices per side. */
+static constexpr uint32_t MIN_FFT_SIZE  = 64;
+static constexpr uint32_t MAX_FFT_SIZE  = 4096;
+static constexpr uint32_t MAX_MESH_SIZE = 512;
+
+/* Spectrum cascades (OceanConfig::cascades): N × N grids over growing patches, transformed
+   together as texture-array layers and summed by the renderer. */
+static constexpr uint32_t MAX_CASCADES = 4;
+
+/* Longest update interval of a decimated cascade (OceanConfig::cascade_interval), frames. */
+static constexpr uint32_t MAX_CASCADE_INTERVAL = 4;
+
+/* GPU memory the N-sized simulation resources may take (OceanSim::resource_bytes); larger
+   configurations run at a lower N. N = 4096 fits in f32 with one cascade and no Jacobian. */
+static constexpr uint64_t MAX_SIM_BYTES = 4096ull * 1024 * 1024;
+
+/* Texture memory a baked loop may take (OceanConfig::loop_frames is capped to fit). */
+static constexpr uint64_t MAX_LOOP_BYTES = 512ull * 1024 * 1024;
+
+/* Where FFT intermediates live. Both backends end in the same output texture array. */
+enum class FftBackend : int {
+    Texture = 0,   /* RGBA32Float storage-texture ping-pong */
+    Buffer  = 1,   /* tightly packed array<vec2f> storage buffer, in-place stages */
+};
+
+/* Butterfly radix of the multi-dispatch stage chain. Radix2 runs the table-driven
+   DIT kernels; Radix4/Radix8 run in-shader-twiddle Stockham kernels that fold
+   two/three radix-2 stages into each dispatch (with a radix-4/2 tail as needed). */
+enum class FftRadix : int {
+    Radix2 = 0,
+    Radix4 = 1,
+    Radix8 = 2,
+};
 
 struct OceanConfig {
+    uint32_t fft_size     = 256;        /* N: simulation grid, power of two in [MIN_FFT_SIZE, MAX_FFT_SIZE] */
     float  patch_size     = 64.f;       /* physical patch width, metres */
     float  lambda         = 30.f;       /* choppiness scale: applied to XY displacement and Jacobian */
     double wave_amplitude = 15.0;       /* JONSWAP spectral scale */
@@ -16,12 +47,33 @@ struct OceanConfig {
     double wind_x         = 40.0;       /* wind velocity x, m/s */
     double wind_y         = 0.0;        /* wind velocity y, m/s */
     double enhancement    = 3.3;        /* JONSWAP peak enhancement gamma */
+    uint32_t seed         = 1;          /* h0 random amplitudes: Philox key, the same ocean on every run and thread count */
+    uint32_t cascades     = 1;          /* 1..MAX_CASCADES; cascade c spans patch_size · cascade_scale^c (rebuilds) */
+    float  cascade_scale  = 4.3f;       /* patch growth per cascade; non-integer so the repeats never line up */
+    bool   decimate_cascades = false;   /* re-simulate cascade c every cascade_interval[c] frames, blend in between */
+    uint32_t cascade_interval[MAX_CASCADES] = { 1, 2, 4, 4 };   /* frames, 1..MAX_CASCADE_INTERVAL */
+    bool   loop           = false;      /* ω snapped to multiples of 2π / loop_period; one period baked, then replayed */
+    float  loop_period    = 20.f;       /* seconds until the surface repeats exactly */
+    uint32_t loop_frames  = 64;         /* baked frames per period, capped by OceanSim::loop_frame_limit */
+    FftBackend backend    = FftBackend::Texture;  /* switchable at runtime for A/B benchmarking */
+    bool       single_dispatch = true;              /* workgroup-memory FFT when the adapter supports it */
+    FftRadix   radix      = FftRadix::Radix2;       /* stage chain radix (texture backend only) */
+    bool       subgroups  = true;                   /* radix-2 chain: first stages via subgroup shuffles, when supported */
+    bool       four_step  = false;                  /* stage chain as two √N-point sub-FFT passes per direction (texture backend) */
+    bool       transposed_vertical = false;         /* vertical IFFT as tiled transpose + horizontal kernels (texture backend) */
+    bool       fused_spectrum = true;               /* evolve h0 inside the first horizontal FFT pass */
+    bool       gpu_spectrum   = true;               /* h0 and k-data generated by spectrum.wgsl instead of on the CPU */
+    bool       band_pruning   = true;               /* drop negligible h0 bands, skip empty rows */
+    float      prune_energy   = 1e-6f;              /* band pruning cutoff, fraction of peak |h0|² */
+    bool       incremental_phase = false;           /* rotate stored phasors by e^{iω·dt} instead of cos/sin(ωt) */
+    bool       half_precision = false;              /* f16 storage for spectra, ping-pong and output */
 };
 
 struct FoamConfig {
     float threshold = 0.97f;    /* Jacobian threshold; foam accumulates when J < threshold */
     float erosion   = 0.95f;  /* per-frame multiplicative decay */
     float foam_add  = 2.f;    /* accumulation rate per breaking pixel */
+    bool  analytic_jacobian = false;   /* spectral Jacobian channel instead of finite differences (rebuilds) */
 };
 
 /* Build-time camera defaults — not exposed via ImGui, adjust here and rebuild. */
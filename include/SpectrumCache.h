@@ -0,0 +1,66 @@
+#pragma once
+
+#include "SimulationConfig.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <utility>
+#include <vector>
+
+/* The CPU-made arrays behind one spectrum upload: the noise layers on the GPU path, h0,
+   k-data and the band pruning table on the CPU path. See OceanSim::build_spectrum. */
+struct SpectrumData {
+    std::vector<float>    noise;           /* GPU path, new seed: the noise texture's layers */
+    std::vector<float>    spectrum;        /* CPU path: h0 of every cascade (f32 textures) */
+    std::vector<uint16_t> spectrum_half;   /* or as RGBA16Float */
+    std::vector<float>    k_data;
+    std::vector<uint32_t> prune_table;
+    uint32_t              rows = 0;
+};
+
+/* Every setting a SpectrumData depends on. Fields the arrays do not depend on are zero
+   (the GPU path caches only its noise: size, layers and seed), so equal settings give
+   equal bytes. No padding: the key is hashed and compared as raw bytes. */
+struct SpectrumKey {
+    double   wave_amplitude = 0.0;
+    double   fetch          = 0.0;
+    double   wind_x         = 0.0;
+    double   wind_y         = 0.0;
+    double   enhancement    = 0.0;
+    float    patch_size     = 0.f;
+    float    cascade_scale  = 0.f;
+    float    prune_energy   = 0.f;
+    float    loop_period    = 0.f;
+    uint32_t version        = 0;
+    uint32_t size           = 0;
+    uint32_t layers         = 0;
+    uint32_t seed           = 0;
+    uint32_t gpu_spectrum   = 0;
+    uint32_t half           = 0;
+    uint32_t band_pruning   = 0;
+    uint32_t loop           = 0;
+
+    static SpectrumKey from(const OceanConfig& ocean, uint32_t size, uint32_t layers, bool half);
+    uint64_t hash() const;
+};
+static_assert(sizeof(SpectrumKey) == 5 * sizeof(double) + 12 * sizeof(uint32_t), "SpectrumKey must not have padding");
+
+/* Generated spectra kept across runs, so a fixed preset skips generation on later launches.
+   One binary file per key in a directory, named by SpectrumKey::hash: a header repeating
+   the key and the array lengths, then the raw arrays in native byte order. A file whose
+   header does not match reads as a miss. Delete the directory to clear it. */
+class SpectrumCache {
+public:
+    explicit SpectrumCache(std::filesystem::path dir) : dir(std::move(dir)) {}
+
+    /* Fills `data` from the file of `key`. False (data untouched) on a miss or a bad file. */
+    bool load(const SpectrumKey& key, SpectrumData& data) const;
+
+    /* Writes the file of `key`, through a temporary so a reader never sees half of it. */
+    void store(const SpectrumKey& key, const SpectrumData& data) const;
+
+private:
+    std::filesystem::path dir;
+
+    std::filesystem::path file(const SpectrumKey& key) const;
+};
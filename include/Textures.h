@@ -1,9 +1,11 @@
 #pragma once
 
 #include <webgpu/webgpu.hpp>
+#include <cstdint>
+#include <cstring>
 
 /* Convenience constructors for common WebGPU texture and texture-view patterns.
-   Both functions create single-mip, single-sample resources. */
+   All functions create single-mip, single-sample resources. */
 namespace texture_helpers {
 
 /* Creates a 2D texture with the given dimensions, format, and usage flags. */
@@ -26,6 +28,27 @@ inline wgpu::Texture create_texture_2d(
     return device.createTexture(d);
 }
 
+/* Creates a 2D texture with `layers` array layers. */
+inline wgpu::Texture create_texture_2d_array(
+    wgpu::Device        device,
+    uint32_t            width,
+    uint32_t            height,
+    uint32_t            layers,
+    wgpu::TextureFormat  format,
+    WGPUTextureUsageFlags usage)
+{
+    wgpu::TextureDescriptor d;
+    d.dimension       = wgpu::TextureDimension::_2D;
+    d.size            = { width, height, layers };
+    d.mipLevelCount   = 1;
+    d.sampleCount     = 1;
+    d.format          = format;
+    d.usage           = usage;
+    d.viewFormatCount = 0;
+    d.viewFormats     = nullptr;
+    return device.createTexture(d);
+}
+
 /* Creates a 2D texture view covering the entire texture (all layers, all mips). */
 inline wgpu::TextureView create_view_2d(wgpu::Texture texture, wgpu::TextureFormat format)
 {
@@ -40,4 +63,65 @@ inline wgpu::TextureView create_view_2d(wgpu::Texture texture, wgpu::TextureForm
     return texture.createView(d);
 }
 
+/* Creates a 2D-array view covering all `layers` layers of the texture. */
+inline wgpu::TextureView create_view_2d_array(wgpu::Texture texture, wgpu::TextureFormat format, uint32_t layers)
+{
+    wgpu::TextureViewDescriptor d;
+    d.aspect          = wgpu::TextureAspect::All;
+    d.baseArrayLayer  = 0;
+    d.arrayLayerCount = layers;
+    d.baseMipLevel    = 0;
+    d.mipLevelCount   = 1;
+    d.dimension       = wgpu::TextureViewDimension::_2DArray;
+    d.format          = format;
+    return texture.createView(d);
+}
+
+/* IEEE binary16 conversion for uploading to / reading back from *16Float textures.
+   float_to_half rounds to nearest; out-of-range values become ±inf. */
+inline uint16_t float_to_half(float value)
+{
+    uint32_t f;
+    std::memcpy(&f, &value, sizeof(f));
+    const uint32_t sign = (f >> 16) & 0x8000u;
+    const uint32_t bexp = (f >> 23) & 0xffu;
+    uint32_t       mant = f & 0x7fffffu;
+    const int32_t  exp  = static_cast<int32_t>(bexp) - 127 + 15;
+
+    if (bexp == 0xffu) return static_cast<uint16_t>(sign | 0x7c00u | (mant ? 0x200u : 0u));
+    if (exp >= 31)     return static_cast<uint16_t>(sign | 0x7c00u);
+    if (exp <= 0) {
+        if (exp < -10) return static_cast<uint16_t>(sign);
+        mant |= 0x800000u;
+        const uint32_t shift = static_cast<uint32_t>(14 - exp);
+        uint32_t h = mant >> shift;
+        if ((mant >> (shift - 1)) & 1u) h++;
+        return static_cast<uint16_t>(sign | h);
+    }
+    uint32_t h = sign | (static_cast<uint32_t>(exp) << 10) | (mant >> 13);
+    if (mant & 0x1000u) h++;   /* a carry into the exponent is still the correct rounding */
+    return static_cast<uint16_t>(h);
+}
+
+inline float half_to_float(uint16_t h)
+{
+    const uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+    const uint32_t exp  = (h >> 10) & 0x1fu;
+    uint32_t       mant = h & 0x3ffu;
+    uint32_t       f;
+
+    if (exp == 0x1fu)   f = sign | 0x7f800000u | (mant << 13);
+    else if (exp != 0)  f = sign | ((exp + 112) << 23) | (mant << 13);
+    else if (mant == 0) f = sign;
+    else {
+        uint32_t e = 113;
+        while (!(mant & 0x400u)) { mant <<= 1; e--; }
+        f = sign | (e << 23) | ((mant & 0x3ffu) << 13);
+    }
+
+    float value;
+    std::memcpy(&value, &f, sizeof(value));
+    return value;
+}
+
 } // namespace texture_helpers
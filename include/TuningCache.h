@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/* Workgroup shape of a tunable kernel family (WG_X × WG_Y, substituted in the WGSL source). */
+struct WorkgroupShape {
+    uint32_t x = 16;
+    uint32_t y = 16;
+};
+
+/* Persistent autotuner results (see OceanSim::autotune): the fastest workgroup shape per
+   kernel and resolution, keyed by adapter vendor, device and driver. Stored as one
+   tab-separated line per entry; entries of other adapters survive every save. */
+class TuningCache {
+public:
+    /* Reads `path` if it exists. adapter_key identifies this adapter + driver. */
+    void init(const std::string& adapter_key, const std::filesystem::path& path);
+
+    /* Cached shape of `kernel` at resolution n on this adapter, if any. */
+    bool lookup(const std::string& kernel, uint32_t n, WorkgroupShape& shape) const;
+
+    /* Records a winner and rewrites the file. */
+    void store(const std::string& kernel, uint32_t n, WorkgroupShape shape);
+
+    const std::string& adapter() const { return adapter_key; }
+
+private:
+    struct Entry {
+        std::string    adapter;
+        std::string    kernel;
+        uint32_t       n = 0;
+        WorkgroupShape shape;
+    };
+
+    std::string           adapter_key;
+    std::filesystem::path file;
+    std::vector<Entry>    entries;
+
+    void save() const;
+};
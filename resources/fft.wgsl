@@ -1,26 +1,69 @@
-struct FourierUniforms {
-    time:  f32,
-    stage: u32,
-    N:     u32,
-    log2n: u32,
-}
+/* Requires spectrum_common.wgsl (ComputeUniforms, complex_mul, packed_spectra). */
 
-@group(0) @binding(0) var<uniform> u:            FourierUniforms;
-@group(0) @binding(1) var          out_tex:       texture_storage_2d<rgba32float, write>;
-@group(0) @binding(2) var          in_tex:        texture_2d<f32>;
+@group(0) @binding(0) var<uniform> u:            ComputeUniforms;
+@group(0) @binding(1) var          out_tex:       texture_storage_2d_array<rgba32float, write>;
+@group(0) @binding(2) var          in_tex:        texture_2d_array<f32>;
 @group(0) @binding(3) var          butterfly_tex: texture_2d<f32>;
+@group(0) @binding(4) var          spectrum_tex:  texture_2d_array<f32>;  /* fused kernels only */
+@group(0) @binding(5) var          k_data_tex:    texture_2d_array<f32>;  /* fused kernels only */
+@group(0) @binding(6) var          disp_out:      texture_storage_2d_array<rgba32float, write>;
+@group(0) @binding(7) var          slope_out:     texture_storage_2d_array<rgba32float, write>;
+
+/* Band pruning table (prune_bands, or listRows in spectrum.wgsl): [0, N) is 1 where the spectrum row holds
+   any energy in any cascade, [N, N + u.rows) lists those rows. The radix-2 and single-dispatch horizontal
+   kernels run over the list only; rows they skip are read back as zero by the first
+   vertical stage (or the transpose), whatever the ping-pong texture still holds there.
+   With u.rows == N every row is listed, which lets the row-only pipeline run the
+   horizontal kernels over a whole transposed grid without a second table. */
+@group(0) @binding(8) var<storage, read> prune: array<u32>;
+
+/* Persistent e^{i·omega·t} per spectrum texel (phasor mode, see texel_phase). */
+@group(0) @binding(9) var<storage, read_write> phasors: array<vec2f>;
+
+fn occupied_row(i: u32) -> i32 {
+    return select(i32(prune[u.N + i]), i32(i), u.rows == u.N);
+}
+
+fn row_live(y: i32) -> bool {
+    return prune[y] != 0u;
+}
+
+/* Workgroup shape, chosen per adapter by OceanSim::autotune (default 16 × 16) and
+   substituted in the source per shape (OceanSim::create_family).
+   Used by the radix-2 stage kernels fft_horizontal, fft_vertical and fft_horizontal_fused. */
+const WG_X: u32 = 16u;
+const WG_Y: u32 = 16u;
 
 fn reverse(x: u32, log2n: u32) -> u32 {
     return reverseBits(x) >> (32u - log2n);
 }
 
-fn complex_mul(a: vec2f, b: vec2f) -> vec2f {
-    return vec2f(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x);
+/* Writes the final spatial values of every channel at `coord` as renderer texels. */
+fn store_surface(coord: vec2i, cascade: u32, c: array<vec2f, MAX_CHANNELS>) {
+    let t = surface_texels(c, 1.0 / f32(u.N));
+    textureStore(disp_out,  coord, cascade, t[0]);
+    textureStore(slope_out, coord, cascade, t[1]);
 }
 
-/* id.x = butterfly index 0..N/2-1, id.y = row 0..N-1 */
-@compute @workgroup_size(16, 16, 1)
+/* h0(k) → packed channel spectra of texel `coord` at its cascade's time, as timeSpectrum computes them. */
+fn evolve(coord: vec2i, cascade: u32) -> array<vec2f, MAX_CHANNELS> {
+    let Ni       = i32(u.N);
+    let mirrored = vec2i((Ni - coord.x) % Ni, (Ni - coord.y) % Ni);
+    let kdata    = textureLoad(k_data_tex, coord, cascade, 0);
+    return packed_spectra(textureLoad(spectrum_tex, coord,    cascade, 0).rg,
+                          textureLoad(spectrum_tex, mirrored, cascade, 0).rg,
+                          kdata,
+                          texel_phase(texel_index(coord, cascade), kdata.b),
+                          1.0 / f32(u.N));
+}
+
+/* id.x = butterfly index 0..N/2-1, id.y = occupied row 0..rows-1, id.z = channel layer */
+@compute @workgroup_size(WG_X, WG_Y, 1)
 fn fft_horizontal(@builtin(global_invocation_id) id: vec3<u32>) {
+    if (id.y >= u.rows || !layer_due(id.z)) {
+        return;
+    }
+
     let stage  = u.stage;
     let data   = textureLoad(butterfly_tex, vec2i(i32(id.x), i32(stage)), 0);
     let tw     = data.rg;
@@ -31,19 +74,24 @@ fn fft_horizontal(@builtin(global_invocation_id) id: vec3<u32>) {
     let read_a = select(writ_a, i32(reverse(u32(writ_a), log2n)), stage == 0u);
     let read_b = select(writ_b, i32(reverse(u32(writ_b), log2n)), stage == 0u);
 
-    let row   = i32(id.y);
-    let a     = textureLoad(in_tex, vec2i(read_a, row), 0).rg;
-    let b     = textureLoad(in_tex, vec2i(read_b, row), 0).rg;
+    let row   = occupied_row(id.y);
+    let layer = i32(id.z);
+    let a     = textureLoad(in_tex, vec2i(read_a, row), layer, 0).rg;
+    let b     = textureLoad(in_tex, vec2i(read_b, row), layer, 0).rg;
     let out_a = a + complex_mul(tw, b);
     let out_b = a - complex_mul(tw, b);
 
-    textureStore(out_tex, vec2i(writ_a, row), vec4f(out_a, 0.0, 1.0));
-    textureStore(out_tex, vec2i(writ_b, row), vec4f(out_b, 0.0, 1.0));
+    textureStore(out_tex, vec2i(writ_a, row), layer, vec4f(out_a, 0.0, 1.0));
+    textureStore(out_tex, vec2i(writ_b, row), layer, vec4f(out_b, 0.0, 1.0));
 }
 
-/* id.x = col 0..N-1, id.y = butterfly index 0..N/2-1 */
-@compute @workgroup_size(16, 16, 1)
+/* id.x = col 0..N-1, id.y = butterfly index 0..N/2-1, id.z = channel layer */
+@compute @workgroup_size(WG_X, WG_Y, 1)
 fn fft_vertical(@builtin(global_invocation_id) id: vec3<u32>) {
+    if (!layer_due(id.z)) {
+        return;
+    }
+
     let stage  = u.stage;
     let data   = textureLoad(butterfly_tex, vec2i(i32(id.y), i32(stage)), 0);
     let tw     = data.rg;
@@ -55,11 +103,448 @@ fn fft_vertical(@builtin(global_invocation_id) id: vec3<u32>) {
     let read_b = select(writ_b, i32(reverse(u32(writ_b), log2n)), stage == 0u);
 
     let col   = i32(id.x);
-    let a     = textureLoad(in_tex, vec2i(col, read_a), 0).rg;
-    let b     = textureLoad(in_tex, vec2i(col, read_b), 0).rg;
+    let layer = i32(id.z);
+    let live_a = stage != 0u || row_live(read_a);
+    let live_b = stage != 0u || row_live(read_b);
+    let a     = select(vec2f(0.0), textureLoad(in_tex, vec2i(col, read_a), layer, 0).rg, live_a);
+    let b     = select(vec2f(0.0), textureLoad(in_tex, vec2i(col, read_b), layer, 0).rg, live_b);
     let out_a = a + complex_mul(tw, b);
     let out_b = a - complex_mul(tw, b);
 
-    textureStore(out_tex, vec2i(col, writ_a), vec4f(out_a, 0.0, 1.0));
-    textureStore(out_tex, vec2i(col, writ_b), vec4f(out_b, 0.0, 1.0));
+    textureStore(out_tex, vec2i(col, writ_a), layer, vec4f(out_a, 0.0, 1.0));
+    textureStore(out_tex, vec2i(col, writ_b), layer, vec4f(out_b, 0.0, 1.0));
+}
+
+/* Stage 0 with the time evolution folded in: each invocation evolves its two
+   (bit-reversed) source frequencies once and writes the butterfly for every
+   channel, so the spectra never round-trip through the ping-pong array.
+   id.x = butterfly index 0..N/2-1, id.y = occupied row 0..rows-1, id.z = cascade. */
+@compute @workgroup_size(WG_X, WG_Y, 1)
+fn fft_horizontal_fused(@builtin(global_invocation_id) id: vec3<u32>) {
+    if (id.y >= u.rows || !cascade_due(id.z)) {
+        return;
+    }
+
+    let data   = textureLoad(butterfly_tex, vec2i(i32(id.x), 0), 0);
+    let tw     = data.rg;
+    let writ_a = i32(data.b + 0.5);
+    let writ_b = i32(data.a + 0.5);
+    let row    = occupied_row(id.y);
+
+    var a = evolve(vec2i(i32(reverse(u32(writ_a), u.log2n)), row), id.z);
+    var b = evolve(vec2i(i32(reverse(u32(writ_b), u.log2n)), row), id.z);
+
+    for (var c = 0; c < i32(FFT_CHANNELS); c++) {
+        let tb    = complex_mul(tw, b[c]);
+        let layer = cascade_layer(id.z, c);
+        textureStore(out_tex, vec2i(writ_a, row), layer, vec4f(a[c] + tb, 0.0, 1.0));
+        textureStore(out_tex, vec2i(writ_b, row), layer, vec4f(a[c] - tb, 0.0, 1.0));
+    }
+}
+
+fn resolve_texel(coord: vec2i, src: vec2i, cascade: u32) {
+    if (!cascade_due(cascade)) {
+        return;
+    }
+    var c: array<vec2f, MAX_CHANNELS>;
+    for (var l = 0; l < i32(FFT_CHANNELS); l++) {
+        c[l] = textureLoad(in_tex, src, cascade_layer(cascade, l), 0).rg;
+    }
+    store_surface(coord, cascade, c);
+}
+
+/* Stage-chain epilogue: the IFFT result (in_tex = fft[0], bind group 1) → renderer texels.
+   id.z = cascade. */
+@compute @workgroup_size(16, 16, 1)
+fn resolve_output(@builtin(global_invocation_id) id: vec3<u32>) {
+    resolve_texel(vec2i(id.xy), vec2i(id.xy), id.z);
+}
+
+/* Row-only pipeline epilogue: the result is still transposed, so read it that way. */
+@compute @workgroup_size(16, 16, 1)
+fn resolve_output_transposed(@builtin(global_invocation_id) id: vec3<u32>) {
+    resolve_texel(vec2i(id.xy), vec2i(id.yx), id.z);
+}
+
+/* Row-only pipeline (OceanConfig::transposed_vertical): the vertical IFFT is the horizontal
+   one on the transposed grid. A 16×16 tile goes through workgroup memory so the loads and
+   the stores both walk rows; the padding column keeps the transposed reads off a single
+   bank. Rows the pruned horizontal pass skipped are written as zero.
+   wid.xy = source tile, wid.z = channel layer. */
+var<workgroup> tile: array<array<vec2f, 17>, 16>;
+
+@compute @workgroup_size(16, 16, 1)
+fn transpose_tiles(@builtin(local_invocation_id) lid: vec3<u32>,
+                   @builtin(workgroup_id)        wid: vec3<u32>) {
+    if (!layer_due(wid.z)) {
+        return;
+    }
+    let layer = i32(wid.z);
+    let src   = vec2i(wid.xy * 16u + lid.xy);
+    tile[lid.y][lid.x] = select(vec2f(0.0), textureLoad(in_tex, src, layer, 0).rg, row_live(src.y));
+    workgroupBarrier();
+
+    let dst = vec2i(wid.yx * 16u + lid.xy);
+    textureStore(out_tex, dst, layer, vec4f(tile[lid.x][lid.y], 0.0, 1.0));
+}
+
+/* ---------------------------------------------------------------------------
+   Higher-radix stage chain: Stockham autosort in global memory, so the input is
+   read in natural order and each dispatch folds log2(radix) radix-2 stages into
+   one texture round trip. Twiddles are computed in-shader (one sincos per
+   invocation, higher powers by complex multiplication); the butterfly table is
+   not used. u.ns = product of the radices of all earlier stages (1 at first).
+   --------------------------------------------------------------------------- */
+
+const TAU: f32 = 6.283185307179586;
+
+fn mul_i(a: vec2f) -> vec2f {
+    return vec2f(-a.y, a.x);
+}
+
+/* Inverse (positive-exponent) 4-point DFT. */
+fn idft4(a0: vec2f, a1: vec2f, a2: vec2f, a3: vec2f) -> array<vec2f, 4> {
+    let t0 = a0 + a2;
+    let t1 = a0 - a2;
+    let t2 = a1 + a3;
+    let t3 = mul_i(a1 - a3);
+    return array<vec2f, 4>(t0 + t2, t1 + t3, t0 - t2, t1 - t3);
+}
+
+/* Inverse 8-point DFT as two 4-point DFTs (even / odd) and one radix-2 combine. */
+fn idft8(v: array<vec2f, 8>) -> array<vec2f, 8> {
+    let e  = idft4(v[0], v[2], v[4], v[6]);
+    let o  = idft4(v[1], v[3], v[5], v[7]);
+    let s  = 0.70710678118654752;
+    let o1 = complex_mul(vec2f( s, s), o[1]);
+    let o2 = mul_i(o[2]);
+    let o3 = complex_mul(vec2f(-s, s), o[3]);
+    return array<vec2f, 8>(e[0] + o[0], e[1] + o1, e[2] + o2, e[3] + o3,
+                           e[0] - o[0], e[1] - o1, e[2] - o2, e[3] - o3);
+}
+
+fn line_texel(horizontal: bool, line_id: u32, i: u32) -> vec2i {
+    return select(vec2i(i32(line_id), i32(i)), vec2i(i32(i), i32(line_id)), horizontal);
+}
+
+/* One radix-R stage on a row (horizontal) or column. j in [0, N/R) picks the
+   butterfly; R is a constant at every call site, so the branches fold away. */
+fn stockham_stage(radix: u32, horizontal: bool, j: u32, line_id: u32, layer: i32) {
+    let stride = u.N / radix;
+    if (j >= stride || !layer_due(u32(layer))) {
+        return;
+    }
+    let ns = u.ns;
+    let k  = j % ns;
+
+    /* Element r is rotated by w^r, w = exp(+i·2π·k / (ns·R)). */
+    let angle = TAU * f32(k) / f32(ns * radix);
+    let w     = vec2f(cos(angle), sin(angle));
+    var wr    = vec2f(1.0, 0.0);
+
+    var v: array<vec2f, 8>;
+    for (var r = 0u; r < radix; r++) {
+        let x = textureLoad(in_tex, line_texel(horizontal, line_id, j + r * stride), layer, 0).rg;
+        v[r]  = complex_mul(wr, x);
+        wr    = complex_mul(wr, w);
+    }
+
+    if (radix == 8u) {
+        v = idft8(v);
+    } else if (radix == 4u) {
+        let d = idft4(v[0], v[1], v[2], v[3]);
+        v[0] = d[0];
+        v[1] = d[1];
+        v[2] = d[2];
+        v[3] = d[3];
+    } else {
+        let a = v[0];
+        v[0]  = a + v[1];
+        v[1]  = a - v[1];
+    }
+
+    let base = (j - k) * radix + k;
+    for (var r = 0u; r < radix; r++) {
+        textureStore(out_tex, line_texel(horizontal, line_id, base + r * ns), layer, vec4f(v[r], 0.0, 1.0));
+    }
+}
+
+/* Horizontal: id.x = j 0..N/R-1, id.y = row. Vertical: id.x = col, id.y = j. id.z = channel layer. */
+@compute @workgroup_size(16, 16, 1)
+fn fft_horizontal_r2(@builtin(global_invocation_id) id: vec3<u32>) {
+    stockham_stage(2u, true, id.x, id.y, i32(id.z));
+}
+
+@compute @workgroup_size(16, 16, 1)
+fn fft_vertical_r2(@builtin(global_invocation_id) id: vec3<u32>) {
+    stockham_stage(2u, false, id.y, id.x, i32(id.z));
+}
+
+@compute @workgroup_size(16, 16, 1)
+fn fft_horizontal_r4(@builtin(global_invocation_id) id: vec3<u32>) {
+    stockham_stage(4u, true, id.x, id.y, i32(id.z));
+}
+
+@compute @workgroup_size(16, 16, 1)
+fn fft_vertical_r4(@builtin(global_invocation_id) id: vec3<u32>) {
+    stockham_stage(4u, false, id.y, id.x, i32(id.z));
+}
+
+@compute @workgroup_size(16, 16, 1)
+fn fft_horizontal_r8(@builtin(global_invocation_id) id: vec3<u32>) {
+    stockham_stage(8u, true, id.x, id.y, i32(id.z));
+}
+
+@compute @workgroup_size(16, 16, 1)
+fn fft_vertical_r8(@builtin(global_invocation_id) id: vec3<u32>) {
+    stockham_stage(8u, false, id.y, id.x, i32(id.z));
+}
+
+/* ---------------------------------------------------------------------------
+   Single-dispatch path: one workgroup owns a whole row (or column), loads it
+   into workgroup memory once and runs every stage there. Radix-2 Stockham
+   autosort, so no bit-reversed load is needed and the output is in order.
+   Requires FFT_N * 2 * 8 bytes of workgroup storage and FFT_N / 2 invocations.
+   FFT_N is substituted per N when the module is built (see OceanSim::init_pipelines):
+   wgpu-native's compiler takes no override constants in sizes.
+   --------------------------------------------------------------------------- */
+
+const FFT_N: u32 = 256u;
+
+/* Two line buffers back to back: [0, N) and [N, 2N), swapped every stage. */
+var<workgroup> line_buf: array<vec2f, FFT_N * 2u>;
+
+/* Runs all log2n stages on line_buf[0..N). Returns the offset of the result. */
+fn stockham_line(j: u32) -> u32 {
+    let half = FFT_N / 2u;
+    var src  = 0u;
+    var dst  = FFT_N;
+
+    for (var s = 0u; s < u.log2n; s++) {
+        let ns = 1u << s;
+        let k  = j & (ns - 1u);
+        let tw = textureLoad(butterfly_tex, vec2i(i32(j), i32(s)), 0).rg;
+        let a  = line_buf[src + j];
+        let b  = complex_mul(tw, line_buf[src + j + half]);
+        let o  = (j - k) * 2u + k;
+
+        line_buf[dst + o]      = a + b;
+        line_buf[dst + o + ns] = a - b;
+        workgroupBarrier();
+
+        let t = src;
+        src   = dst;
+        dst   = t;
+    }
+    return src;
+}
+
+/* lid.x = butterfly index 0..N/2-1, wid.y = occupied row 0..rows-1, wid.z = channel layer */
+@compute @workgroup_size(FFT_N / 2u, 1, 1)
+fn fft_horizontal_shared(@builtin(local_invocation_id) lid: vec3<u32>,
+                         @builtin(workgroup_id)        wid: vec3<u32>) {
+    if (!layer_due(wid.z)) {
+        return;
+    }
+    let j     = lid.x;
+    let half  = FFT_N / 2u;
+    let row   = occupied_row(wid.y);
+    let layer = i32(wid.z);
+
+    line_buf[j]        = textureLoad(in_tex, vec2i(i32(j),        row), layer, 0).rg;
+    line_buf[j + half] = textureLoad(in_tex, vec2i(i32(j + half), row), layer, 0).rg;
+    workgroupBarrier();
+
+    let res = stockham_line(j);
+    textureStore(out_tex, vec2i(i32(j),        row), layer, vec4f(line_buf[res + j],        0.0, 1.0));
+    textureStore(out_tex, vec2i(i32(j + half), row), layer, vec4f(line_buf[res + j + half], 0.0, 1.0));
+}
+
+/* Last pass: each column transforms every channel in turn and keeps its two outputs
+   per channel in registers, so it can write the renderer texels directly instead of
+   another ping-pong layer. lid.x = butterfly index 0..N/2-1, wid.x = col 0..N-1,
+   wid.z = cascade. */
+@compute @workgroup_size(FFT_N / 2u, 1, 1)
+fn fft_vertical_shared(@builtin(local_invocation_id) lid: vec3<u32>,
+                       @builtin(workgroup_id)        wid: vec3<u32>) {
+    if (!cascade_due(wid.z)) {
+        return;
+    }
+    let j    = lid.x;
+    let half = FFT_N / 2u;
+    let col  = i32(wid.x);
+    let base = cascade_layer(wid.z, 0);
+
+    var lo: array<vec2f, MAX_CHANNELS>;
+    var hi: array<vec2f, MAX_CHANNELS>;
+    /* Rows the pruned horizontal pass skipped are zero. */
+    let live_lo = row_live(i32(j));
+    let live_hi = row_live(i32(j + half));
+    for (var c = 0; c < i32(FFT_CHANNELS); c++) {
+        line_buf[j]        = select(vec2f(0.0), textureLoad(in_tex, vec2i(col, i32(j)),        base + c, 0).rg, live_lo);
+        line_buf[j + half] = select(vec2f(0.0), textureLoad(in_tex, vec2i(col, i32(j + half)), base + c, 0).rg, live_hi);
+        workgroupBarrier();
+
+        let res = stockham_line(j);
+        lo[c] = line_buf[res + j];
+        hi[c] = line_buf[res + j + half];
+        workgroupBarrier();
+    }
+
+    store_surface(vec2i(col, i32(j)),        wid.z, lo);
+    store_surface(vec2i(col, i32(j + half)), wid.z, hi);
+}
+
+/* Fused evolution + whole row IFFT. One workgroup per row evolves its 2 × N/2
+   frequencies once, keeps all channels in registers and runs them through line_buf
+   one after another, so workgroup memory stays at 2·N entries.
+   lid.x = butterfly index 0..N/2-1, wid.y = occupied row 0..rows-1, wid.z = cascade. */
+@compute @workgroup_size(FFT_N / 2u, 1, 1)
+fn fft_horizontal_fused_shared(@builtin(local_invocation_id) lid: vec3<u32>,
+                               @builtin(workgroup_id)        wid: vec3<u32>) {
+    if (!cascade_due(wid.z)) {
+        return;
+    }
+    let j    = lid.x;
+    let half = FFT_N / 2u;
+    let row  = occupied_row(wid.y);
+    let base = cascade_layer(wid.z, 0);
+
+    var lo = evolve(vec2i(i32(j),        row), wid.z);
+    var hi = evolve(vec2i(i32(j + half), row), wid.z);
+
+    for (var c = 0; c < i32(FFT_CHANNELS); c++) {
+        line_buf[j]        = lo[c];
+        line_buf[j + half] = hi[c];
+        workgroupBarrier();
+
+        let res = stockham_line(j);
+        textureStore(out_tex, vec2i(i32(j),        row), base + c, vec4f(line_buf[res + j],        0.0, 1.0));
+        textureStore(out_tex, vec2i(i32(j + half), row), base + c, vec4f(line_buf[res + j + half], 0.0, 1.0));
+        workgroupBarrier();   /* line_buf is refilled for the next channel */
+    }
+}
+
+/* ---------------------------------------------------------------------------
+   Four-step (Bailey) path for large N, where a whole line no longer fits in
+   workgroup memory. Each line of N = N1·N2 points is transformed as N1 sub-FFTs
+   of length N2 over the stride-N1 subsequences, a twiddle multiply, then N2
+   sub-FFTs of length N1 over contiguous blocks:
+     step one:  Y[k2·N1 + n1] = e^{iτ·n1·k2/N} · Σ_n2 x[n1 + N1·n2] · e^{iτ·n2·k2/N2}
+     step two:  X[k2 + N2·k1] = Σ_n1 Y[k2·N1 + n1] · e^{iτ·n1·k1/N1}
+   Both transposes are folded into the load / store indexing, so a direction is
+   two dispatches whatever N is. FS_M is the sub-FFT length of the pipeline
+   (N2 for step one, N1 for step two), substituted per step like FFT_N; each
+   workgroup runs FS_LINES of them.
+   --------------------------------------------------------------------------- */
+
+const FS_M: u32 = 64u;
+const FS_LINES: u32 = 4u;
+
+/* Per sub-FFT: two FS_M-entry buffers back to back, swapped every stage. */
+var<workgroup> fs_buf: array<vec2f, FS_M * 2u * FS_LINES>;
+
+/* stockham_line on the sub-FFT at fs_buf[base, base + 2·FS_M). The butterfly table's
+   (j, s) twiddle depends on s only, not on N, so it serves any FS_M <= N. */
+fn stockham_sub(j: u32, base: u32) -> u32 {
+    let half = FS_M / 2u;
+    var src  = base;
+    var dst  = base + FS_M;
+
+    for (var s = 0u; s < countTrailingZeros(FS_M); s++) {
+        let ns = 1u << s;
+        let k  = j & (ns - 1u);
+        let tw = textureLoad(butterfly_tex, vec2i(i32(j), i32(s)), 0).rg;
+        let a  = fs_buf[src + j];
+        let b  = complex_mul(tw, fs_buf[src + j + half]);
+        let o  = (j - k) * 2u + k;
+
+        fs_buf[dst + o]      = a + b;
+        fs_buf[dst + o + ns] = a - b;
+        workgroupBarrier();
+
+        let t = src;
+        src   = dst;
+        dst   = t;
+    }
+    return src;
+}
+
+/* lid.x = butterfly 0..FS_M/2-1, lid.y = sub-FFT slot, wid.x·FS_LINES + lid.y = n1,
+   wid.y = line (occupied row index when horizontal), wid.z = channel layer. The vertical
+   step reads rows the pruned horizontal pass skipped as zero. */
+fn four_step_one(horizontal: bool, lid: vec3<u32>, wid: vec3<u32>) {
+    if (!layer_due(wid.z)) {
+        return;
+    }
+    let j      = lid.x;
+    let half   = FS_M / 2u;
+    let n1     = wid.x * FS_LINES + lid.y;
+    let stride = u.N / FS_M;
+    let base   = lid.y * FS_M * 2u;
+    let line   = select(wid.y, u32(occupied_row(wid.y)), horizontal);
+    let layer  = i32(wid.z);
+
+    for (var e = j; e < FS_M; e += half) {
+        let src  = n1 + stride * e;
+        let live = horizontal || row_live(i32(src));
+        fs_buf[base + e] = select(vec2f(0.0), textureLoad(in_tex, line_texel(horizontal, line, src), layer, 0).rg, live);
+    }
+    workgroupBarrier();
+
+    let res = stockham_sub(j, base);
+    for (var k2 = j; k2 < FS_M; k2 += half) {
+        let angle = TAU * f32((n1 * k2) % u.N) / f32(u.N);
+        let y     = complex_mul(vec2f(cos(angle), sin(angle)), fs_buf[res + k2]);
+        textureStore(out_tex, line_texel(horizontal, line, k2 * stride + n1), layer, vec4f(y, 0.0, 1.0));
+    }
+}
+
+/* As four_step_one, with wid.x·FS_LINES + lid.y = k2: the contiguous block k2·N1.. in,
+   the stride-N2 outputs k2 + N2·k1 out. */
+fn four_step_two(horizontal: bool, lid: vec3<u32>, wid: vec3<u32>) {
+    if (!layer_due(wid.z)) {
+        return;
+    }
+    let j      = lid.x;
+    let half   = FS_M / 2u;
+    let k2     = wid.x * FS_LINES + lid.y;
+    let stride = u.N / FS_M;
+    let base   = lid.y * FS_M * 2u;
+    let line   = select(wid.y, u32(occupied_row(wid.y)), horizontal);
+    let layer  = i32(wid.z);
+
+    for (var e = j; e < FS_M; e += half) {
+        fs_buf[base + e] = textureLoad(in_tex, line_texel(horizontal, line, k2 * FS_M + e), layer, 0).rg;
+    }
+    workgroupBarrier();
+
+    let res = stockham_sub(j, base);
+    for (var k1 = j; k1 < FS_M; k1 += half) {
+        textureStore(out_tex, line_texel(horizontal, line, k2 + stride * k1), layer, vec4f(fs_buf[res + k1], 0.0, 1.0));
+    }
+}
+
+@compute @workgroup_size(FS_M / 2u, FS_LINES, 1)
+fn fft_horizontal_four_step_1(@builtin(local_invocation_id) lid: vec3<u32>,
+                              @builtin(workgroup_id)        wid: vec3<u32>) {
+    four_step_one(true, lid, wid);
+}
+
+@compute @workgroup_size(FS_M / 2u, FS_LINES, 1)
+fn fft_horizontal_four_step_2(@builtin(local_invocation_id) lid: vec3<u32>,
+                              @builtin(workgroup_id)        wid: vec3<u32>) {
+    four_step_two(true, lid, wid);
+}
+
+@compute @workgroup_size(FS_M / 2u, FS_LINES, 1)
+fn fft_vertical_four_step_1(@builtin(local_invocation_id) lid: vec3<u32>,
+                            @builtin(workgroup_id)        wid: vec3<u32>) {
+    four_step_one(false, lid, wid);
+}
+
+@compute @workgroup_size(FS_M / 2u, FS_LINES, 1)
+fn fft_vertical_four_step_2(@builtin(local_invocation_id) lid: vec3<u32>,
+                            @builtin(workgroup_id)        wid: vec3<u32>) {
+    four_step_two(false, lid, wid);
 }
@@ -0,0 +1,162 @@
+/* Storage-buffer FFT backend. Requires spectrum_common.wgsl.
+
+   Spectra live in one tightly packed array<vec2f> (cascades × FFT_CHANNELS × N × N, one complex
+   value per element) instead of RGBA32Float texels. timeSpectrumBuffer scatters each
+   frequency to its bit-reversed (x, y) position, so both IFFT passes run as in-place
+   radix-2 DIT on the same read_write buffer with no ping-pong copy. Only the final
+   resolve_buffer step writes the displacement and slope textures the renderer reads.
+
+   StorageComplex (vec2<f32>, or vec2<f16> under shader-f16) is declared by the loader in
+   front of this file; arithmetic always happens in f32. */
+
+@group(0) @binding(0) var<uniform>             u:             ComputeUniforms;
+@group(0) @binding(1) var<storage, read_write> data:          array<StorageComplex>;
+@group(0) @binding(2) var                      spectrum_tex:  texture_2d_array<f32>;
+@group(0) @binding(3) var                      k_data_tex:    texture_2d_array<f32>;
+@group(0) @binding(4) var                      butterfly_tex: texture_2d<f32>;
+@group(0) @binding(5) var                      disp_out:      texture_storage_2d_array<rgba32float, write>;
+@group(0) @binding(6) var                      slope_out:     texture_storage_2d_array<rgba32float, write>;
+@group(0) @binding(7) var<storage, read_write> phasors:       array<vec2f>;
+
+fn reverse(x: u32, log2n: u32) -> u32 {
+    return reverseBits(x) >> (32u - log2n);
+}
+
+/* layer = cascade · FFT_CHANNELS + channel, as the texture arrays of the texture backend. */
+fn index_of(x: u32, y: u32, layer: u32) -> u32 {
+    return (layer * u.N + y) * u.N + x;
+}
+
+/* id.xy = texel, id.z = cascade */
+@compute @workgroup_size(16, 16, 1)
+fn timeSpectrumBuffer(@builtin(global_invocation_id) id: vec3<u32>) {
+    if (!cascade_due(id.z)) {
+        return;
+    }
+
+    let Ni       = i32(u.N);
+    let coord    = vec2i(id.xy);
+    let mirrored = vec2i((Ni - coord.x) % Ni, (Ni - coord.y) % Ni);
+    let cascade  = i32(id.z);
+
+    let kdata   = textureLoad(k_data_tex, coord, cascade, 0);
+    let spectra = packed_spectra(textureLoad(spectrum_tex, coord,    cascade, 0).rg,
+                                 textureLoad(spectrum_tex, mirrored, cascade, 0).rg,
+                                 kdata,
+                                 texel_phase(texel_index(coord, id.z), kdata.b),
+                                 1.0 / f32(u.N));
+
+    let rx = reverse(id.x, u.log2n);
+    let ry = reverse(id.y, u.log2n);
+    for (var l = 0; l < i32(FFT_CHANNELS); l++) {
+        data[index_of(rx, ry, u32(cascade_layer(id.z, l)))] = StorageComplex(spectra[l]);
+    }
+}
+
+/* One butterfly in place: both operands are read and written by the same invocation. */
+fn butterfly_in_place(ia: u32, ib: u32, tw: vec2f) {
+    let a = vec2f(data[ia]);
+    let b = complex_mul(tw, vec2f(data[ib]));
+    data[ia] = StorageComplex(a + b);
+    data[ib] = StorageComplex(a - b);
+}
+
+/* id.x = butterfly index 0..N/2-1, id.y = row 0..N-1, id.z = channel layer */
+@compute @workgroup_size(16, 16, 1)
+fn fft_horizontal_buffer(@builtin(global_invocation_id) id: vec3<u32>) {
+    if (!layer_due(id.z)) {
+        return;
+    }
+    let bf = textureLoad(butterfly_tex, vec2i(i32(id.x), i32(u.stage)), 0);
+    butterfly_in_place(index_of(u32(bf.b + 0.5), id.y, id.z),
+                       index_of(u32(bf.a + 0.5), id.y, id.z), bf.rg);
+}
+
+/* id.x = col 0..N-1, id.y = butterfly index 0..N/2-1, id.z = channel layer */
+@compute @workgroup_size(16, 16, 1)
+fn fft_vertical_buffer(@builtin(global_invocation_id) id: vec3<u32>) {
+    if (!layer_due(id.z)) {
+        return;
+    }
+    let bf = textureLoad(butterfly_tex, vec2i(i32(id.y), i32(u.stage)), 0);
+    butterfly_in_place(index_of(id.x, u32(bf.b + 0.5), id.z),
+                       index_of(id.x, u32(bf.a + 0.5), id.z), bf.rg);
+}
+
+/* ---------------------------------------------------------------------------
+   Single-dispatch variants: one workgroup per line, all stages in workgroup
+   memory. The line is already bit-reversed, so one N-element buffer suffices.
+   --------------------------------------------------------------------------- */
+
+const FFT_N: u32 = 256u;   /* substituted per N, as in fft.wgsl */
+
+var<workgroup> line_buf: array<vec2f, FFT_N>;
+
+fn dit_line(j: u32) {
+    for (var s = 0u; s < u.log2n; s++) {
+        let bf = textureLoad(butterfly_tex, vec2i(i32(j), i32(s)), 0);
+        let ia = u32(bf.b + 0.5);
+        let ib = u32(bf.a + 0.5);
+        let a  = line_buf[ia];
+        let b  = complex_mul(bf.rg, line_buf[ib]);
+        line_buf[ia] = a + b;
+        line_buf[ib] = a - b;
+        workgroupBarrier();
+    }
+}
+
+/* lid.x = butterfly index 0..N/2-1, wid.y = row 0..N-1, wid.z = channel layer */
+@compute @workgroup_size(FFT_N / 2u, 1, 1)
+fn fft_horizontal_buffer_shared(@builtin(local_invocation_id) lid: vec3<u32>,
+                             @builtin(workgroup_id)        wid: vec3<u32>) {
+    if (!layer_due(wid.z)) {
+        return;
+    }
+    let j    = lid.x;
+    let half = FFT_N / 2u;
+
+    line_buf[j]        = vec2f(data[index_of(j,        wid.y, wid.z)]);
+    line_buf[j + half] = vec2f(data[index_of(j + half, wid.y, wid.z)]);
+    workgroupBarrier();
+
+    dit_line(j);
+    data[index_of(j,        wid.y, wid.z)] = StorageComplex(line_buf[j]);
+    data[index_of(j + half, wid.y, wid.z)] = StorageComplex(line_buf[j + half]);
+}
+
+/* lid.x = butterfly index 0..N/2-1, wid.x = col 0..N-1, wid.z = channel layer */
+@compute @workgroup_size(FFT_N / 2u, 1, 1)
+fn fft_vertical_buffer_shared(@builtin(local_invocation_id) lid: vec3<u32>,
+                           @builtin(workgroup_id)        wid: vec3<u32>) {
+    if (!layer_due(wid.z)) {
+        return;
+    }
+    let j    = lid.x;
+    let half = FFT_N / 2u;
+
+    line_buf[j]        = vec2f(data[index_of(wid.x, j,        wid.z)]);
+    line_buf[j + half] = vec2f(data[index_of(wid.x, j + half, wid.z)]);
+    workgroupBarrier();
+
+    dit_line(j);
+    data[index_of(wid.x, j,        wid.z)] = StorageComplex(line_buf[j]);
+    data[index_of(wid.x, j + half, wid.z)] = StorageComplex(line_buf[j + half]);
+}
+
+/* Writes the spatial-domain result as the displacement and slope textures the renderer
+   and foam pass read. id.z = cascade: every invocation gathers all channels of its texel. */
+@compute @workgroup_size(16, 16, 1)
+fn resolve_buffer(@builtin(global_invocation_id) id: vec3<u32>) {
+    if (!cascade_due(id.z)) {
+        return;
+    }
+
+    var c: array<vec2f, MAX_CHANNELS>;
+    for (var l = 0; l < i32(FFT_CHANNELS); l++) {
+        c[l] = vec2f(data[index_of(id.x, id.y, u32(cascade_layer(id.z, l)))]);
+    }
+
+    let t = surface_texels(c, 1.0 / f32(u.N));
+    textureStore(disp_out,  vec2i(id.xy), id.z, t[0]);
+    textureStore(slope_out, vec2i(id.xy), id.z, t[1]);
+}
@@ -0,0 +1,126 @@
+/* Requires spectrum_common.wgsl and fft.wgsl (bindings, reverse, evolve, row_live) and the
+   subgroups extension, which OceanSim prepends as an enable directive. Only compiled when
+   the device was created with the subgroup feature (see Application::init).
+
+   Subgroup prologue of the radix-2 DIT chain: the first SG_STAGES stages of every line in
+   one dispatch instead of SG_STAGES texture round trips. Each invocation holds one element
+   of a SG_BLOCK-wide block; a stage's butterfly partner (x ^ half) sits in the same block,
+   and in the same subgroup while half < subgroup size. Those stages exchange operands with
+   subgroupShuffleXor, wider ones through workgroup memory, so any subgroup size works.
+   The chain then continues at stage SG_STAGES with the table kernels. */
+
+const SG_BLOCK:  u32 = 32u;
+const SG_STAGES: u32 = 5u;   /* log2(SG_BLOCK); OceanSim::subgroup_stages must match */
+const SG_LINES:  u32 = 8u;
+
+var<workgroup> sg_buf:   array<vec2f, SG_BLOCK * SG_LINES>;
+var<workgroup> sg_gap:   atomic<u32>;
+var<workgroup> sg_width: u32;
+
+/* Widest butterfly span every subgroup of the workgroup can shuffle: the smallest subgroup
+   size, or 1 if any subgroup's lanes do not follow local_invocation_index (the shuffle
+   partner would then not be element x ^ half). Workgroup-uniform. */
+fn shuffle_width(lindex: u32, sg_id: u32, sg_size: u32) -> u32 {
+    let linear = sg_id == lindex % sg_size;
+    atomicMax(&sg_gap, SG_BLOCK / select(1u, min(sg_size, SG_BLOCK), linear));
+    workgroupBarrier();
+    if (lindex == 0u) {
+        sg_width = SG_BLOCK / atomicLoad(&sg_gap);
+    }
+    return workgroupUniformLoad(&sg_width);
+}
+
+/* Runs DIT stages [0, SG_STAGES) on element x of a line, v = line[reverse(x)].
+   slot = local_invocation_index, so slot ^ half is the partner's sg_buf entry. */
+fn subgroup_stages(v_in: vec2f, x: u32, slot: u32, width: u32) -> vec2f {
+    var v = v_in;
+    for (var s = 0u; s < SG_STAGES; s++) {
+        let half = 1u << s;
+        var p: vec2f;
+        if (half < width) {
+            p = subgroupShuffleXor(v, half);
+        } else {
+            sg_buf[slot] = v;
+            workgroupBarrier();
+            p = sg_buf[slot ^ half];
+            workgroupBarrier();
+        }
+        /* Same twiddle as the butterfly table: entry (x mod half, s). */
+        let tw = textureLoad(butterfly_tex, vec2i(i32(x & (half - 1u)), i32(s)), 0).rg;
+        v = select(v + complex_mul(tw, p), p - complex_mul(tw, v), (x & half) != 0u);
+    }
+    return v;
+}
+
+/* id.x = position 0..N-1 along the row, id.y = occupied row 0..rows-1, id.z = channel layer.
+   Invocations past u.rows still take part in the exchanges but store nothing. The
+   decimation test reads wid.z (= id.z) so that it stays workgroup-uniform. */
+@compute @workgroup_size(SG_BLOCK, SG_LINES, 1)
+fn fft_horizontal_subgroup(@builtin(global_invocation_id)   id:      vec3<u32>,
+                           @builtin(local_invocation_index) lindex:  u32,
+                           @builtin(subgroup_invocation_id) sg_id:   u32,
+                           @builtin(subgroup_size)          sg_size: u32,
+                           @builtin(workgroup_id)           wid:     vec3<u32>) {
+    if (!layer_due(wid.z)) {
+        return;
+    }
+    let width = shuffle_width(lindex, sg_id, sg_size);
+    let live  = id.y < u.rows;
+    let row   = occupied_row(min(id.y, u.rows - 1u));
+    let layer = i32(id.z);
+
+    let v = textureLoad(in_tex, vec2i(i32(reverse(id.x, u.log2n)), row), layer, 0).rg;
+    let r = subgroup_stages(v, id.x, lindex, width);
+    if (live) {
+        textureStore(out_tex, vec2i(i32(id.x), row), layer, vec4f(r, 0.0, 1.0));
+    }
+}
+
+/* id.x = position 0..N-1 along the column, id.y = col 0..N-1, id.z = channel layer.
+   Rows the pruned horizontal pass skipped are read as zero, as in fft_vertical. */
+@compute @workgroup_size(SG_BLOCK, SG_LINES, 1)
+fn fft_vertical_subgroup(@builtin(global_invocation_id)   id:      vec3<u32>,
+                         @builtin(local_invocation_index) lindex:  u32,
+                         @builtin(subgroup_invocation_id) sg_id:   u32,
+                         @builtin(subgroup_size)          sg_size: u32,
+                         @builtin(workgroup_id)           wid:     vec3<u32>) {
+    if (!layer_due(wid.z)) {
+        return;
+    }
+    let width = shuffle_width(lindex, sg_id, sg_size);
+    let col   = i32(id.y);
+    let layer = i32(id.z);
+    let src   = i32(reverse(id.x, u.log2n));
+
+    let v = select(vec2f(0.0), textureLoad(in_tex, vec2i(col, src), layer, 0).rg, row_live(src));
+    let r = subgroup_stages(v, id.x, lindex, width);
+    textureStore(out_tex, vec2i(col, i32(id.x)), layer, vec4f(r, 0.0, 1.0));
+}
+
+/* Fused evolution + prologue: each live invocation evolves its bit-reversed source
+   frequency once (texel_phase advances every texel exactly once) and runs every channel
+   through the stages in turn. id.x, id.y as fft_horizontal_subgroup; id.z = cascade. */
+@compute @workgroup_size(SG_BLOCK, SG_LINES, 1)
+fn fft_horizontal_fused_subgroup(@builtin(global_invocation_id)   id:      vec3<u32>,
+                                 @builtin(local_invocation_index) lindex:  u32,
+                                 @builtin(subgroup_invocation_id) sg_id:   u32,
+                                 @builtin(subgroup_size)          sg_size: u32,
+                                 @builtin(workgroup_id)           wid:     vec3<u32>) {
+    if (!cascade_due(wid.z)) {
+        return;
+    }
+    let width = shuffle_width(lindex, sg_id, sg_size);
+    let live  = id.y < u.rows;
+    let row   = occupied_row(min(id.y, u.rows - 1u));
+
+    var c: array<vec2f, MAX_CHANNELS>;
+    if (live) {
+        c = evolve(vec2i(i32(reverse(id.x, u.log2n)), row), id.z);
+    }
+    for (var l = 0; l < i32(FFT_CHANNELS); l++) {
+        let r = subgroup_stages(c[l], id.x, lindex, width);
+        if (live) {
+            textureStore(out_tex, vec2i(i32(id.x), row), cascade_layer(id.z, l), vec4f(r, 0.0, 1.0));
+        }
+    }
+}
@@ -1,25 +1,68 @@
 struct FoamUniforms {
-    lambda:    f32,
-    threshold: f32,
-    erosion:   f32,
-    fft_n:     f32,
-    foam_add:  f32,
-    _pad0:     f32,
-    _pad1:     f32,
-    _pad2:     f32,
+    lambda:     f32,
+    threshold:  f32,
+    erosion:    f32,
+    fft_n:      f32,
+    foam_add:   f32,
+    texel_size: f32,   /* patch_size / N, metres */
+    cascades:   u32,
+    _pad1:      f32,
+    cascade_scale: vec4f,   /* per cascade: patch_size / cascade patch (1 for cascade 0) */
+    cascade_blend: vec4f,   /* per cascade: weight of the current layer (1 unless decimated) */
 }
 
 @group(0) @binding(0) var<uniform> u:          FoamUniforms;
 @group(0) @binding(1) var          foam_prev:  texture_2d<f32>;
 @group(0) @binding(2) var          foam_out:   texture_storage_2d<r32float, write>;
-@group(0) @binding(3) var          disp_x_tex: texture_2d<f32>;
-@group(0) @binding(4) var          disp_y_tex: texture_2d<f32>;
+@group(0) @binding(3) var          disp_tex:   texture_2d_array<f32>;  /* .r = disp-x, .g = disp-y, .a = Jxy (normalised) */
+@group(0) @binding(4) var          slope_tex:  texture_2d_array<f32>;  /* .b = Jxx, .a = Jyy (analytic Jacobian only) */
+@group(0) @binding(5) var          surface_sampler: sampler;         /* bilinear, repeat */
 
-@compute @workgroup_size(16, 16, 1)
+/* The foam grid is cascade 0's. The other cascades are sampled at the same world position:
+   cascade-0 texel p lies at texel p · cascade_scale of cascade c, so their sum is the
+   rendered surface (see water.wgsl). */
+fn cascade_uv(coord: vec2i, cascade: u32) -> vec2f {
+    return (vec2f(coord) * u.cascade_scale[cascade] + 0.5) / u.fft_n;
+}
+
+/* Cascade c of `tex` as rendered: decimated cascades blend from their previous result in
+   layer cascades + c (see water.wgsl). */
+fn cascade_texel(tex: texture_2d_array<f32>, uv: vec2f, c: u32) -> vec4f {
+    let t = textureSampleLevel(tex, surface_sampler, uv, c, 0.0);
+    if (u.cascade_blend[c] >= 1.0) {
+        return t;
+    }
+    return mix(textureSampleLevel(tex, surface_sampler, uv, u.cascades + c, 0.0), t, u.cascade_blend[c]);
+}
+
+fn surface_disp(coord: vec2i) -> vec4f {
+    var d = vec4f(0.0);
+    for (var c = 0u; c < u.cascades; c++) {
+        d += cascade_texel(disp_tex, cascade_uv(coord, c), c);
+    }
+    return d;
+}
+
+/* Workgroup shape, chosen per adapter by OceanSim::autotune (default 16 × 16) and
+   substituted in the source per shape (OceanSim::create_family). */
+const WG_X: u32 = 16u;
+const WG_Y: u32 = 16u;
+
+/* Marks breaking pixels (J < threshold) and erodes the previous accumulation. The
+   partial derivatives are per texel. */
+fn accumulate_foam(coord: vec2i, jxx: f32, jyy: f32, jxy: f32) {
+    let J        = (1.0 + u.lambda * jxx) * (1.0 + u.lambda * jyy)
+                 - (u.lambda * jxy) * (u.lambda * jxy);
+    let biased_j = max(0.0, -(J - u.threshold));
+    let new_f    = u.foam_add * biased_j;
+    let eroded   = textureLoad(foam_prev, coord, 0).r * u.erosion;
+    textureStore(foam_out, coord, vec4f(min(eroded + new_f, 1.0), 0.0, 0.0, 0.0));
+}
+
+@compute @workgroup_size(WG_X, WG_Y, 1)
 fn computeFoam(@builtin(global_invocation_id) id: vec3<u32>) {
     let coord = vec2i(id.xy);
     let N     = i32(u.fft_n);
-    let inv   = 1.0 / (u.fft_n * u.fft_n);
 
     /* Wrap-safe neighbour coordinates. */
     let xp = (coord + vec2i(1,   0)) % vec2i(N);
@@ -28,14 +71,31 @@ fn computeFoam(@builtin(global_invocation_id) id: vec3<u32>) {
     let ym = (coord + vec2i(0, N-1)) % vec2i(N);
 
     /* Full 2×2 Jacobian determinant via finite differences. */
-    let jxx = (textureLoad(disp_x_tex, xp, 0).r - textureLoad(disp_x_tex, xm, 0).r) * inv * 0.5;
-    let jyy = (textureLoad(disp_y_tex, yp, 0).r - textureLoad(disp_y_tex, ym, 0).r) * inv * 0.5;
-    let jxy = (textureLoad(disp_x_tex, yp, 0).r - textureLoad(disp_x_tex, ym, 0).r) * inv * 0.5;
+    let dxp = surface_disp(xp);
+    let dxm = surface_disp(xm);
+    let dyp = surface_disp(yp);
+    let dym = surface_disp(ym);
+    let jxx = (dxp.r - dxm.r) * 0.5;
+    let jyy = (dyp.g - dym.g) * 0.5;
+    let jxy = (dyp.r - dym.r) * 0.5;
 
-    let J        = (1.0 + u.lambda * jxx) * (1.0 + u.lambda * jyy)
-                 - (u.lambda * jxy) * (u.lambda * jxy);
-    let biased_j = max(0.0, -(J - u.threshold));
-    let new_f    = u.foam_add * biased_j;
-    let eroded   = textureLoad(foam_prev, coord, 0).r * u.erosion;
-    textureStore(foam_out, coord, vec4f(min(eroded + new_f, 1.0), 0.0, 0.0, 0.0));
+    accumulate_foam(coord, jxx, jyy, jxy);
+}
+
+/* Exact Jacobian from the spectral channels: two fetches at the texel itself and no
+   neighbours. The derivatives come out per metre; scaling by the texel size gives the
+   per-texel units of computeFoam, so threshold and λ mean the same in both variants.
+   Per-metre derivatives of the cascades simply add up. */
+@compute @workgroup_size(WG_X, WG_Y, 1)
+fn computeFoamSpectral(@builtin(global_invocation_id) id: vec3<u32>) {
+    let coord = vec2i(id.xy);
+    var jxy   = 0.0;
+    var jac   = vec2f(0.0);
+    for (var c = 0u; c < u.cascades; c++) {
+        let uv = cascade_uv(coord, c);
+        jxy += cascade_texel(disp_tex,  uv, c).a;
+        jac += cascade_texel(slope_tex, uv, c).ba;
+    }
+
+    accumulate_foam(coord, jac.x * u.texel_size, jac.y * u.texel_size, jxy * u.texel_size);
 }
@@ -0,0 +1,148 @@
+/* h0(k) and k-data generation on the GPU (OceanSim::generate_gpu_spectrum). Texel for texel
+   the same as generate_spectrum and prune_bands in OceanSim.cpp, up to f32 rounding of the
+   JONSWAP terms (and jonswap_batch's exp2 polynomial): the Gaussian draws come from the
+   noise texture, which holds the CPU generator's draws for the current seed, so both paths
+   build the same ocean. */
+
+struct SpectrumUniforms {
+    wind:        vec2f,   /* wind velocity, m/s */
+    peak_freq:   f32,     /* JONSWAP peak wavenumber (host-side invariant) */
+    alpha:       f32,     /* JONSWAP energy scale (host-side invariant) */
+    enhancement: f32,     /* peak enhancement gamma */
+    omega_step:  f32,     /* looping mode: ω snapped to multiples of this; 0 = off */
+    cutoff:      f32,     /* band pruning: fraction of peak |h0|² dropped; 0 = off */
+    N:           u32,
+    patch:       vec4f,   /* per cascade: patch width, metres */
+    amplitude:   vec4f,   /* per cascade: wave_amplitude with Δk relative to cascade 0 */
+    k_min:       vec4f,   /* per cascade: energy band [k_min, k_max) */
+    k_max:       vec4f,
+}
+
+struct SpectrumStats {
+    peak: atomic<u32>,   /* max |h0|² as f32 bits: non-negative floats order like their bits */
+    rows: u32,           /* occupied rows, read back by OceanSim::read_row_count */
+}
+
+@group(0) @binding(0) var<uniform>             s:         SpectrumUniforms;
+@group(0) @binding(1) var                      noise_tex: texture_2d_array<f32>;   /* .rg = two N(0, 1) draws */
+@group(0) @binding(2) var                      h0_out:    texture_storage_2d_array<rgba32float, write>;
+@group(0) @binding(3) var                      k_out:     texture_storage_2d_array<rgba32float, write>;
+@group(0) @binding(4) var<storage, read_write> stats:     SpectrumStats;
+/* Band pruning table as fft.wgsl reads it: [0, N) row mask, then the row list. */
+@group(0) @binding(5) var<storage, read_write> prune:     array<atomic<u32>>;
+
+const PI: f32 = 3.14159265358979;
+const G:  f32 = 9.81;
+
+/* Wavevector of texel `coord` of a cascade: indices above N/2 are negative frequencies. */
+fn wave_vector(coord: vec2i, cascade: u32) -> vec2f {
+    let n = i32(s.N);
+    let m = select(coord, coord - vec2i(n), coord > vec2i(n / 2));
+    return 2.0 * PI * vec2f(m) / s.patch[cascade];
+}
+
+/* Deep-water dispersion, snapped to the loop's ω grid in looping mode. */
+fn dispersion(k_len: f32) -> f32 {
+    let omega = sqrt(G * k_len);
+    if (s.omega_step == 0.0) {
+        return omega;
+    }
+    return round(omega / s.omega_step) * s.omega_step;
+}
+
+fn jonswap(k: vec2f) -> f32 {
+    let freq = length(k);
+    if (freq < 0.001) {
+        return 0.0;
+    }
+    let sigma     = select(0.09, 0.07, freq <= s.peak_freq);
+    let d         = (freq - s.peak_freq) / (sigma * s.peak_freq);
+    let r         = exp(-0.5 * d * d);
+    let cos_theta = dot(k, s.wind) / (freq * length(s.wind));
+    let dir       = cos_theta * cos_theta;
+    let ratio     = s.peak_freq / freq;
+    let ratio2    = ratio * ratio;
+    return s.alpha * (G * G / pow(freq, 5.0))
+         * exp(-1.25 * ratio2 * ratio2)
+         * pow(s.enhancement, r)
+         * dir * dir;
+}
+
+/* Of a Hermitian pair, the texel with the larger linear index draws both values and its
+   mirror takes the conjugate, as the CPU loop leaves them. Self-mirrored texels are real. */
+struct Texel {
+    h0:    vec2f,
+    kdata: vec4f,   /* kx, ky, ω, |k| */
+}
+
+fn spectrum_texel(coord: vec2i, cascade: u32) -> Texel {
+    let n      = i32(s.N);
+    let mirror = (vec2i(n) - coord) % n;
+    let t      = coord.y * n + coord.x;
+    let m      = mirror.y * n + mirror.x;
+    let owner  = select(mirror, coord, t >= m);
+
+    let k       = wave_vector(owner, cascade);
+    let k_len   = sqrt(dot(k, k));
+    let in_band = k_len >= s.k_min[cascade] && k_len < s.k_max[cascade];
+    let scale   = select(0.0, sqrt(jonswap(k) * 0.5) * s.amplitude[cascade], in_band);
+
+    var h = textureLoad(noise_tex, owner, cascade, 0).rg * scale;
+    if (t == m) {
+        h.y = 0.0;
+    } else if (t < m) {
+        h.y = -h.y;
+    }
+    let flip = select(-1.0, 1.0, t >= m);
+    return Texel(h, vec4f(flip * k, dispersion(k_len), k_len));
+}
+
+/* id.xy = texel, id.z = cascade. Band pruning only: the peak the cutoff is relative to. */
+@compute @workgroup_size(16, 16, 1)
+fn measureSpectrum(@builtin(global_invocation_id) id: vec3<u32>) {
+    let h0 = spectrum_texel(vec2i(id.xy), id.z).h0;
+    atomicMax(&stats.peak, bitcast<u32>(dot(h0, h0)));
+}
+
+/* Writes h0 and k-data, dropping texels below the cutoff, and marks the rows that keep
+   any energy. |h0(k)| = |h0(-k)|, so the mask stays Hermitian. */
+@compute @workgroup_size(16, 16, 1)
+fn generateSpectrum(@builtin(global_invocation_id) id: vec3<u32>) {
+    let coord = vec2i(id.xy);
+    let texel = spectrum_texel(coord, id.z);
+
+    var h0 = texel.h0;
+    let peak = bitcast<f32>(atomicLoad(&stats.peak));
+    if (s.cutoff > 0.0 && dot(h0, h0) < s.cutoff * peak) {
+        h0 = vec2f(0.0);
+    }
+    if (any(h0 != vec2f(0.0))) {
+        atomicOr(&prune[id.y], 1u);
+    }
+
+    textureStore(h0_out, coord, id.z, vec4f(h0, 0.0, 0.0));
+    textureStore(k_out,  coord, id.z, texel.kdata);
+}
+
+/* One invocation: N is at most 4096, so a serial scan is cheaper than a parallel
+   compaction. The occupied rows are listed first and counted; the empty ones follow, so
+   any row count between that and N dispatches correctly (the host runs N until the
+   count is read back). An all-zero grid still counts one row so the dispatches stay non-empty. */
+@compute @workgroup_size(1)
+fn listRows() {
+    var rows = 0u;
+    for (var y = 0u; y < s.N; y++) {
+        if (atomicLoad(&prune[y]) != 0u) {
+            atomicStore(&prune[s.N + rows], y);
+            rows++;
+        }
+    }
+    var next = rows;
+    for (var y = 0u; y < s.N; y++) {
+        if (atomicLoad(&prune[y]) == 0u) {
+            atomicStore(&prune[s.N + next], y);
+            next++;
+        }
+    }
+    stats.rows = max(rows, 1u);
+}
@@ -0,0 +1,139 @@
+/* Helpers shared by the spectrum kernels. Concatenated in front of time_spectrum.wgsl,
+   fft.wgsl and fft_buffer.wgsl at load time (see ResourceManager::load_shader_module).
+   Each of them declares `u: ComputeUniforms` and a read_write `phasors` buffer, which
+   texel_phase uses. */
+
+struct ComputeUniforms {
+    time:     f32,
+    stage:    u32,
+    N:        u32,
+    log2n:    u32,
+    ns:       u32,   /* Stockham stage chain: product of the radices of earlier stages */
+    rows:     u32,   /* band pruning: number of occupied spectrum rows (N when off) */
+    dt:       f32,   /* phasor mode: seconds since the previous frame */
+    halvings: u32,   /* phasor mode: rotor angle is scaled by 2^-halvings, then squared back */
+    phasor:   u32,   /* 1: evolve from the persistent phasor buffer, 0: cos/sin(omega·time) */
+    cascades: u32,   /* spectrum cascades, one block of FFT_CHANNELS layers each */
+    active:   u32,   /* bit c: cascade c is re-simulated this frame (see cascade_due) */
+    amplitude: f32,  /* wave_amplitude relative to the one h0 was generated with */
+    cascade_time: vec4f,   /* time each active cascade is evolved to; texel_phase reads these */
+    cascade_dt:   vec4f,   /* phasor mode: seconds since that cascade's previous update */
+}
+
+/* All spatial fields are real, so they are packed two per complex channel:
+   IFFT(A + i·B) = a + i·b whenever A and B are Hermitian. One array layer per channel.
+   FFT_CHANNELS is the number actually transformed: the loader substitutes 4u when the
+   analytic Jacobian is enabled. Per-texel arrays are always MAX_CHANNELS long so the
+   LAYER_* indices stay valid in both variants; unused entries are zero. */
+const MAX_CHANNELS: u32 = 4u;
+const FFT_CHANNELS: u32 = 3u;
+const LAYER_HDX:    i32 = 0;  /* H  + i·Dx  */
+const LAYER_SLOPE:  i32 = 1;  /* Sx + i·Sy  */
+const LAYER_DY:     i32 = 2;  /* Dy + i·Jxy */
+const LAYER_JAC:    i32 = 3;  /* Jxx + i·Jyy, FFT_CHANNELS == 4 only */
+
+/* Cascades (OceanConfig::cascades) stack their channel blocks in the same arrays, so the
+   per-layer kernels transform all of them in one dispatch: layer = cascade · FFT_CHANNELS
+   + channel. The h0, k-data and output arrays have one layer per cascade. */
+fn cascade_layer(cascade: u32, channel: i32) -> i32 {
+    return i32(cascade * FFT_CHANNELS) + channel;
+}
+
+/* Cascade decimation (OceanConfig::cascade_interval): every kernel returns early for the
+   cascades that are not due this frame, which keep their previous outputs. The test is
+   per workgroup (z never straddles cascades), so it is safe ahead of barriers. */
+fn cascade_due(cascade: u32) -> bool {
+    return ((u.active >> cascade) & 1u) != 0u;
+}
+
+fn layer_due(layer: u32) -> bool {
+    return cascade_due(layer / FFT_CHANNELS);
+}
+
+/* Phasor / omega index of spectrum texel (x, y) of a cascade. */
+fn texel_index(coord: vec2i, cascade: u32) -> u32 {
+    return (cascade * u.N + u32(coord.y)) * u.N + u32(coord.x);
+}
+
+fn complex_mul(a: vec2f, b: vec2f) -> vec2f {
+    return vec2f(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x);
+}
+
+/* Render-ready texels from the three IFFT results (real + imaginary parts per LAYER_*):
+   [0] = displacement (dx, dy, h, Jxy), [1] = slope (sx, sy, Jxx, Jyy). Undoes the 1/N pre-scale of
+   packed_spectra; patch-size scaling is left to the renderer. */
+fn surface_texels(c: array<vec2f, MAX_CHANNELS>, inv_n: f32) -> array<vec4f, 2> {
+    let hdx = c[LAYER_HDX];
+    let dy  = c[LAYER_DY];
+    return array<vec4f, 2>(vec4f(hdx.y, dy.x, hdx.x, dy.y) * inv_n,
+                           vec4f(c[LAYER_SLOPE], c[LAYER_JAC]) * inv_n);
+}
+
+/* a + i·b for complex a, b. */
+fn pack_real_pair(a: vec2f, b: vec2f) -> vec2f {
+    return vec2f(a.x - b.y, a.y + b.x);
+}
+
+/* e^{i·omega·dt} without transcendentals: a Taylor polynomial (degree 6 / 5) of the
+   angle scaled down by 2^halvings, where the host keeps |angle| <= 0.25 so truncation
+   stays below f32 epsilon, then squared back up. */
+fn phase_rotor(omega: f32, dt: f32, halvings: u32) -> vec2f {
+    let x  = omega * dt / f32(1u << halvings);
+    let x2 = x * x;
+    var r  = vec2f(1.0 - x2 * (0.5 - x2 * (1.0 / 24.0 - x2 / 720.0)),
+                   x * (1.0 - x2 * (1.0 / 6.0 - x2 / 120.0)));
+    for (var i = 0u; i < halvings; i++) {
+        r = complex_mul(r, r);
+    }
+    return r;
+}
+
+/* e^{i·omega·t} for the spectrum texel `index` (texel_index), t = its cascade's time. In
+   phasor mode the texel's persistent phasor is advanced by one update and written back,
+   so exactly one invocation may evolve each texel per frame; a Newton step per update
+   keeps |p| at 1. */
+fn texel_phase(index: u32, omega: f32) -> vec2f {
+    let cascade = index / (u.N * u.N);
+    if (u.phasor == 0u) {
+        let phase = omega * u.cascade_time[cascade];
+        return vec2f(cos(phase), sin(phase));
+    }
+    var p = complex_mul(phasors[index], phase_rotor(omega, u.cascade_dt[cascade], u.halvings));
+    p *= 1.5 - 0.5 * dot(p, p);
+    phasors[index] = p;
+    return p;
+}
+
+/* Evolves h0(k) by `phase` = e^{i·omega·t} and derives the packed channel spectra, indexed
+   by LAYER_*. h0_mirror is h0(-k) as stored; kdata is (kx, ky, omega, |k|). Everything is scaled by
+   `scale` (1/N at the call sites) so the unnormalised 2D IFFT peaks at N·amplitude instead
+   of N²·amplitude, which keeps the RGBA16Float storage mode well inside half range. Live
+   wave-amplitude edits ride along as u.amplitude, so they never regenerate h0. */
+fn packed_spectra(h0: vec2f, h0_mirror: vec2f, kdata: vec4f, phase: vec2f, scale: f32) -> array<vec2f, MAX_CHANNELS> {
+    let kx    = kdata.r;
+    let ky    = kdata.g;
+
+    let exp_pos = phase;
+    let exp_neg = vec2f(phase.x, -phase.y);
+
+    let h0_neg = vec2f(h0_mirror.x, -h0_mirror.y);
+    let h      = (complex_mul(h0, exp_pos) + complex_mul(h0_neg, exp_neg)) * (scale * u.amplitude);
+
+    /* Slope spectra: i*k*H → (-k·h.im, k·h.re) */
+    let sx = vec2f(-kx * h.y, kx * h.x);
+    let sy = vec2f(-ky * h.y, ky * h.x);
+
+    /* Choppy displacement spectra: i*(k/|k|)*H */
+    let inv_k = select(0.0, 1.0 / kdata.a, kdata.a > 0.001);
+    let dx    = vec2f(-kx * inv_k * h.y,  kx * inv_k * h.x);
+    let dy    = vec2f(-ky * inv_k * h.y,  ky * inv_k * h.x);
+
+    /* Displacement Jacobian spectra: i·k_j·D_i = -(k_i·k_j / |k|)·H, real multiples of H.
+       Jxy rides in the otherwise empty imaginary half of the Dy channel. */
+    let jxx = h * (-kx * kx * inv_k);
+    let jyy = h * (-ky * ky * inv_k);
+    let jxy = h * (-kx * ky * inv_k);
+
+    return array<vec2f, MAX_CHANNELS>(pack_real_pair(h, dx), pack_real_pair(sx, sy),
+                                      pack_real_pair(dy, jxy), pack_real_pair(jxx, jyy));
+}
@@ -7,8 +7,8 @@ struct VertexInput {
 struct VertexOutput {
 	@builtin(position) position: vec4f,
 	@location(0) fs_position: vec3f,
-	@location(1) fs_normal: vec3f,
-	@location(2) fs_uv: vec2f,
+	@location(1) fs_uv: vec2f,   /* normals are per pixel from slope_tex */
+	@location(2) fs_patch_uv: vec2f,   /* fs_uv + tile offset: position in cascade-0 patches */
 };
 
 struct RenderUniforms {
@@ -19,47 +19,93 @@ struct RenderUniforms {
 	N:          f32,
 	patch_size: f32,
 	lambda:     f32,
+	cascades:   u32,
+	foam_blend: f32,        /* weight of the current foam layer */
+	cascade_scale: vec4f,   /* per cascade: patch_size / cascade patch (1 for cascade 0) */
+	cascade_blend: vec4f,   /* per cascade: weight of the current layer (1 unless decimated or looping) */
+	layers:        vec4u,   /* first disp / slope layer of the current and previous result, then the foam layers */
 }
 
 @group(0) @binding(0) var<uniform> u:            RenderUniforms;
-@group(0) @binding(1) var          heightTexture: texture_2d<f32>;
+@group(0) @binding(1) var          disp_tex:      texture_2d_array<f32>;  /* per cascade: .r = disp-x, .g = disp-y, .b = height */
 @group(0) @binding(2) var          envSampler:    sampler;
 @group(0) @binding(3) var          envMap:        texture_cube<f32>;
-@group(0) @binding(4) var          slope_x_tex:   texture_2d<f32>;
-@group(0) @binding(5) var          slope_y_tex:   texture_2d<f32>;
-@group(0) @binding(6) var          disp_x_tex:    texture_2d<f32>;
-@group(0) @binding(7) var          disp_y_tex:    texture_2d<f32>;
-@group(0) @binding(8) var          foam_tex:        texture_2d<f32>;
-@group(0) @binding(9) var          foam_detail_tex: texture_2d<f32>;
+@group(0) @binding(4) var          foam_tex:        texture_2d_array<f32>;
+@group(0) @binding(5) var          foam_detail_tex: texture_2d<f32>;
+@group(0) @binding(6) var          slope_tex:       texture_2d_array<f32>;  /* per cascade: .r = slope-x, .g = slope-y */
+
+/* disp_tex / slope_tex are already normalised by the FFT's last pass (surface_texels).
+   patch_uv is the position in cascade-0 patches; cascade c repeats every 1 / cascade_scale[c]
+   of them. Sample half a texel in so mesh vertices that land on texels hit their centres. */
+fn surface_uv(patch_uv: vec2f, cascade: u32) -> vec2f {
+	return patch_uv * u.cascade_scale[cascade] + 0.5 / u.N;
+}
 
-@vertex
-fn vs_main(in: VertexInput) -> VertexOutput {
-	var out: VertexOutput;
+/* Cascade c sits at layer layers.x + c. Decimated cascades (OceanSim::schedule_cascades)
+   and loop playback blend from the previous result at layers.y + c; the branch is
+   uniform, so it is fine around textureSample. */
+fn cascade_disp(uv: vec2f, c: u32) -> vec3f {
+	let d = textureSampleLevel(disp_tex, envSampler, uv, u.layers.x + c, 0.0).rgb;
+	if (u.cascade_blend[c] >= 1.0) {
+		return d;
+	}
+	return mix(textureSampleLevel(disp_tex, envSampler, uv, u.layers.y + c, 0.0).rgb, d, u.cascade_blend[c]);
+}
 
-	let uv       = in.uv;
-	let N        = u.N;
-	let inv      = 1.0 / (N * N);
-	let scale_xy = 2.0 / u.patch_size;
+fn cascade_slope(uv: vec2f, c: u32) -> vec2f {
+	let s = textureSample(slope_tex, envSampler, uv, u.layers.x + c).rg;
+	if (u.cascade_blend[c] >= 1.0) {
+		return s;
+	}
+	return mix(textureSample(slope_tex, envSampler, uv, u.layers.y + c).rg, s, u.cascade_blend[c]);
+}
 
-	let tc = vec2i(uv * N) % vec2i(i32(N));
-	let h  = textureLoad(heightTexture, tc, 0).r * inv;
-	let dx = textureLoad(disp_x_tex,   tc, 0).r * inv * scale_xy;
-	let dy = textureLoad(disp_y_tex,   tc, 0).r * inv * scale_xy;
+fn surface_foam(uv: vec2f) -> f32 {
+	let f = textureSample(foam_tex, envSampler, uv, u.layers.z).r;
+	if (u.foam_blend >= 1.0) {
+		return f;
+	}
+	return mix(textureSample(foam_tex, envSampler, uv, u.layers.w).r, f, u.foam_blend);
+}
 
-	let sx = textureLoad(slope_x_tex, tc, 0).r * inv * (u.patch_size * 0.5);
-	let sy = textureLoad(slope_y_tex, tc, 0).r * inv * (u.patch_size * 0.5);
+/* The cascades cover disjoint wavenumber bands (OceanSim::upload_spectrum), so the
+   surface is their sum. Displacements are metres and slopes per metre in every cascade. */
+fn surface_disp(patch_uv: vec2f) -> vec3f {
+	var d = vec3f(0.0);
+	for (var c = 0u; c < u.cascades; c++) {
+		d += cascade_disp(surface_uv(patch_uv, c), c);
+	}
+	return d;
+}
 
+fn surface_slope(patch_uv: vec2f) -> vec2f {
+	var s = vec2f(0.0);
+	for (var c = 0u; c < u.cascades; c++) {
+		s += cascade_slope(surface_uv(patch_uv, c), c);
+	}
+	return s;
+}
+
+@vertex
+fn vs_main(in: VertexInput) -> VertexOutput {
+	var out: VertexOutput;
+
+	let uv     = in.uv;
 	let tile_x = f32(i32(in.instance) % 3 - 1);
 	let tile_y = f32(i32(in.instance) / 3 - 1);
 
+	let patch_uv = uv + vec2f(tile_x, tile_y);
+	let disp     = surface_disp(patch_uv);
+	let d_xy     = disp.xy * (2.0 / u.patch_size);
+
 	let base      = uv * 2.0 - 1.0;
-	let localPos  = vec3f(base.x + u.lambda * dx + tile_x * 2.0,
-	                      base.y + u.lambda * dy + tile_y * 2.0, h);
+	let localPos  = vec3f(base.x + u.lambda * d_xy.x + tile_x * 2.0,
+	                      base.y + u.lambda * d_xy.y + tile_y * 2.0, disp.z);
 	let worldPos4 = u.model * vec4f(localPos, 1.0);
 
 	out.fs_position = worldPos4.xyz;
-	out.fs_normal   = normalize(vec3f(-sx, -sy, 1.0));
 	out.fs_uv       = uv;
+	out.fs_patch_uv = patch_uv;
 	out.position    = u.proj * u.view * worldPos4;
 
 	return out;
@@ -68,13 +114,14 @@ fn vs_main(in: VertexInput) -> VertexOutput {
 @fragment
 fn fs_main(in: VertexOutput) -> @location(0) vec4f {
 
-	let N = normalize(in.fs_normal);
+	let slope = surface_slope(in.fs_patch_uv) * (u.patch_size * 0.5);
+	let N     = normalize(vec3f(-slope, 1.0));
 
 	let L = normalize(vec3f(0.5, 0.5, 1.0));
 	let V = normalize(u.eye - in.fs_position);
 	let H = normalize(L + V);
 
-	let foam        = textureSample(foam_tex,        envSampler, in.fs_uv).r;
+	let foam        = surface_foam(in.fs_uv);
 	let foam_detail = textureSample(foam_detail_tex, envSampler, in.fs_uv * 8.0).r;
 	let foam_mask   = foam * foam_detail;
 
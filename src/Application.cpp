@@ -4,10 +4,50 @@
 #include "Application.h"
 
 #include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
+#include <random>
 
 using namespace wgpu;
 
+/* Halves N until the simulation fits MAX_SIM_BYTES: toggling cascades, the Jacobian or f32
+   at a high N would otherwise allocate several GiB of textures without any check. */
+void fit_resolution(SimulationConfig& config)
+{
+    const uint32_t wanted = config.ocean.fft_size;
+    const uint64_t needed = OceanSim::resource_bytes(config);
+    while (config.ocean.fft_size > MIN_FFT_SIZE && OceanSim::resource_bytes(config) > MAX_SIM_BYTES)
+        config.ocean.fft_size /= 2;
+    if (config.ocean.fft_size != wanted)
+        std::cout << "N=" << wanted << " needs " << needed / (1024 * 1024) << " MiB of the "
+                  << MAX_SIM_BYTES / (1024 * 1024) << " MiB budget, running at N=" << config.ocean.fft_size << '\n';
+}
+
+/* SliderFloat that writes `value` only when released: the spectrum-shape fields make
+   OceanSim regenerate h0 on change, which should happen once per drag, not every frame.
+   Only one widget is active at a time, so a single staging slot suffices. */
+bool slider_on_release(const char* label, float* value, float min, float max,
+                       const char* format = "%.3f", ImGuiSliderFlags flags = 0)
+{
+    static ImGuiID staged_id = 0;
+    static float   staged    = 0.f;
+
+    const ImGuiID id = ImGui::GetID(label);
+    float shown = staged_id == id ? staged : *value;
+    ImGui::SliderFloat(label, &shown, min, max, format, flags);
+    if (ImGui::IsItemActive()) {
+        staged_id = id;
+        staged    = shown;
+        return false;
+    }
+    if (staged_id != id) return false;
+    staged_id = 0;
+    *value    = shown;
+    return true;
+}
+
 // ---------------------------------------------------------------------------
 // Construction / destruction
 // ---------------------------------------------------------------------------
@@ -24,7 +64,20 @@ Application::Application(int w, int h)
     glfwSetCursorPosCallback(window, on_cursor_pos);
     glfwSetScrollCallback(window, on_scroll);
 
+#ifdef WEBGPU_BACKEND_DAWN
+    /* Subgroups are an experimental Dawn feature, only exposed with unsafe APIs allowed.
+       OceanSim::init checks the subgroup kernels against the plain chain before using them. */
+    const char* dawn_toggle_names[] = { "allow_unsafe_apis" };
+    WGPUDawnTogglesDescriptor dawn_toggles = {};
+    dawn_toggles.chain.sType        = WGPUSType_DawnTogglesDescriptor;
+    dawn_toggles.enabledToggleCount = 1;
+    dawn_toggles.enabledToggles     = dawn_toggle_names;
+    WGPUInstanceDescriptor instance_desc = {};
+    instance_desc.nextInChain = &dawn_toggles.chain;
+    Instance instance = wgpuCreateInstance(&instance_desc);
+#else
     Instance instance = wgpuCreateInstance(nullptr);
+#endif
 
     surface = glfwGetWGPUSurface(instance, window);
     RequestAdapterOptions adapter_opts = {};
@@ -34,9 +87,26 @@ Application::Application(int w, int h)
 
     DeviceDescriptor device_desc = {};
     device_desc.label = "Main device";
-    WGPUFeatureName features[] = { WGPUFeatureName_Float32Filterable };
-    device_desc.requiredFeatureCount = 1;
-    device_desc.requiredFeatures     = features;
+#ifdef WEBGPU_BACKEND_DAWN
+    device_desc.nextInChain = &dawn_toggles.chain;
+#endif
+    /* Timestamp queries are optional: without them the profiler panel stays empty.
+       shader-f16 is optional too: without it only the buffer backend's half mode falls back to f32.
+       wgpu-native 0.19 reports it but its WGSL parser rejects `enable f16`, so it is not requested there.
+       So are subgroups (Dawn only): without them the radix-2 chain runs every stage as its own dispatch. */
+    std::vector<WGPUFeatureName> features = { WGPUFeatureName_Float32Filterable };
+    if (adapter.hasFeature(FeatureName::TimestampQuery))
+        features.push_back(WGPUFeatureName_TimestampQuery);
+#ifndef WEBGPU_BACKEND_WGPU
+    if (adapter.hasFeature(FeatureName::ShaderF16))
+        features.push_back(WGPUFeatureName_ShaderF16);
+#endif
+#ifdef WEBGPU_BACKEND_DAWN
+    if (adapter.hasFeature(SUBGROUP_FEATURE))
+        features.push_back(SUBGROUP_FEATURE);
+#endif
+    device_desc.requiredFeatureCount = features.size();
+    device_desc.requiredFeatures     = features.data();
     device_desc.defaultQueue.label   = "Main queue";
     device_desc.deviceLostCallback   = [](WGPUDeviceLostReason reason, char const* msg, void*) {
         std::cout << "Device lost: " << reason;
@@ -66,6 +136,14 @@ Application::Application(int w, int h)
     surface_config.alphaMode   = CompositeAlphaMode::Auto;
     surface.configure(surface_config);
 
+    /* Autotuned workgroup shapes are only valid for this GPU and driver. */
+    AdapterProperties props = {};
+    adapter.getProperties(&props);
+    char adapter_key[256];
+    snprintf(adapter_key, sizeof(adapter_key), "%04x:%04x %s", props.vendorID, props.deviceID,
+             props.driverDescription ? props.driverDescription : "");
+    tuning_cache.init(adapter_key, "autotune.cache");
+
     adapter.release();
 
     /* Camera — initialised from CameraConfig. */
@@ -78,7 +156,9 @@ Application::Application(int w, int h)
     camera.zoom_max          = config.camera.zoom_max;
 
     /* Subsystem initialisation. */
-    ocean.init(device, queue, config);
+    fit_resolution(config);
+    profiler.init(device);
+    ocean.init(device, queue, config, &profiler, &tuning_cache, &spectrum_cache);
     renderer.init(device, queue, surface_format, width, height, config);
     renderer.init_cubemap(config);
     renderer.rebuild_bind_group(ocean, foam_idx);
@@ -95,14 +175,152 @@ Application::Application(int w, int h)
     /* Register UI panels. */
     ui_panels.push_back([this]() {
         ImGui::Begin("Ocean");
+        /* Applied at the start of the next frame (see main_loop). */
+        static const char* sizes[] = { "64", "128", "256", "512", "1024", "2048", "4096" };
+        /* Sizes over MAX_SIM_BYTES with the current precision, cascades and Jacobian are greyed out. */
+        const int size_idx = std::countr_zero(config.ocean.fft_size) - std::countr_zero(MIN_FFT_SIZE);
+        if (ImGui::BeginCombo("Resolution", sizes[size_idx])) {
+            for (int i = 0; i < IM_ARRAYSIZE(sizes); i++) {
+                SimulationConfig candidate = config;
+                candidate.ocean.fft_size = MIN_FFT_SIZE << i;
+                const uint64_t bytes = OceanSim::resource_bytes(candidate);
+                const bool     fits  = bytes <= MAX_SIM_BYTES;
+                if (ImGui::Selectable(sizes[i], i == size_idx, fits ? 0 : ImGuiSelectableFlags_Disabled))
+                    config.ocean.fft_size = candidate.ocean.fft_size;
+                if (!fits && ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+                    ImGui::SetTooltip("Needs %llu MiB, over the %llu MiB budget",
+                                      static_cast<unsigned long long>(bytes / (1024 * 1024)),
+                                      static_cast<unsigned long long>(MAX_SIM_BYTES / (1024 * 1024)));
+            }
+            ImGui::EndCombo();
+        }
         ImGui::SliderFloat("Choppiness",    &config.ocean.lambda,      0.f,    40.f);
-        ImGui::SliderFloat("Patch size",    &config.ocean.patch_size,  16.f,  512.f);
+        /* Spectrum edits apply on the next tick (OceanSim::classify_change): the amplitude as a
+           uniform, everything else by regenerating h0, so those sliders commit on release. */
+        slider_on_release("Patch size", &config.ocean.patch_size, 16.f, 512.f);
         ImGui::InputDouble("Wave amplitude", &config.ocean.wave_amplitude);
         ImGui::InputDouble("Wind speed X",   &config.ocean.wind_x);
         ImGui::InputDouble("Wind speed Y",   &config.ocean.wind_y);
         ImGui::InputDouble("Fetch",          &config.ocean.fetch);
-        if (ImGui::Button("Rebuild spectrum"))
-            ocean.rebuild_spectrum(config);
+        /* The cascade count resizes the arrays (rebuild); the scale only regenerates h0. */
+        int cascades = static_cast<int>(config.ocean.cascades);
+        if (ImGui::SliderInt("Cascades", &cascades, 1, static_cast<int>(MAX_CASCADES)))
+            config.ocean.cascades = static_cast<uint32_t>(cascades);
+        ImGui::BeginDisabled(config.ocean.cascades < 2);
+        slider_on_release("Cascade scale", &config.ocean.cascade_scale, 2.f, 8.f);
+        ImGui::EndDisabled();
+        if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+            ImGui::SetTooltip("Patch growth per cascade; every cascade runs in the same dispatches");
+        /* Intervals apply on the next tick, which restarts the update schedule. */
+        ImGui::Checkbox("Decimate cascades", &config.ocean.decimate_cascades);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Re-simulate cascade c every N frames and blend between its last two\n"
+                              "results; compare the FFT rows in the Profiler panel");
+        if (config.ocean.decimate_cascades) {
+            for (uint32_t c = 0; c < config.ocean.cascades; c++) {
+                char name[32];
+                snprintf(name, sizeof(name), "Cascade %u interval", c);
+                int interval = static_cast<int>(config.ocean.cascade_interval[c]);
+                if (ImGui::SliderInt(name, &interval, 1, static_cast<int>(MAX_CASCADE_INTERVAL)))
+                    config.ocean.cascade_interval[c] = static_cast<uint32_t>(interval);
+            }
+        }
+        /* The period re-snaps ω and the frame count rebakes, both once the slider is released. */
+        ImGui::Checkbox("Loop", &config.ocean.loop);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Snap wave frequencies so the surface repeats every period, bake one\n"
+                              "period and replay it without any compute passes");
+        if (config.ocean.loop) {
+            slider_on_release("Loop period (s)", &config.ocean.loop_period, 5.f, 120.f);
+            /* The slider stops at what fits MAX_LOOP_BYTES at this N; a config asking for more
+               (e.g. after raising N) bakes the capped count, shown next to it. */
+            const uint32_t limit = ocean.loop_frame_limit();
+            if (limit >= 2) {
+                int frames = static_cast<int>(std::min(config.ocean.loop_frames, limit));
+                if (ImGui::SliderInt("Loop frames", &frames, static_cast<int>(std::min(limit, 8u)),
+                                     static_cast<int>(std::min(limit, 256u))))
+                    config.ocean.loop_frames = static_cast<uint32_t>(frames);
+                if (ImGui::IsItemDeactivatedAfterEdit())
+                    ocean.rebake_loop();
+                if (config.ocean.loop_frames > limit)
+                    ImGui::TextDisabled("Baking %u frames (memory limit)", limit);
+            } else {
+                ImGui::TextDisabled("Loop too large to bake at this N: simulating live");
+            }
+            if (ImGui::Button("Rebake loop"))
+                ocean.rebake_loop();
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("Choppiness is applied at playback; foam settings are baked");
+        }
+        int backend = static_cast<int>(config.ocean.backend);
+        if (ImGui::Combo("FFT backend", &backend, "Storage texture\0Storage buffer\0"))
+            config.ocean.backend = static_cast<FftBackend>(backend);
+        if (config.ocean.backend == FftBackend::Buffer && !ocean.supports_buffer_backend())
+            ImGui::TextDisabled("Spectrum buffer too large at this N: storage texture in use");
+        ImGui::BeginDisabled(!ocean.supports_single_dispatch());
+        ImGui::Checkbox("Single-dispatch FFT", &config.ocean.single_dispatch);
+        ImGui::EndDisabled();
+        int radix = static_cast<int>(config.ocean.radix);
+        if (ImGui::Combo("Stage radix", &radix, "Radix-2\0Radix-4\0Radix-8\0"))
+            config.ocean.radix = static_cast<FftRadix>(radix);
+        ImGui::Checkbox("Four-step FFT", &config.ocean.four_step);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Replaces the stage chain: two sqrt(N)-point sub-FFT passes per direction");
+        ImGui::Checkbox("Transposed vertical pass", &config.ocean.transposed_vertical);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Tiled transpose + row kernels instead of column strides (radix-2 / single-dispatch)");
+        ImGui::BeginDisabled(!ocean.supports_subgroups());
+        ImGui::Checkbox("Subgroup butterflies", &config.ocean.subgroups);
+        ImGui::EndDisabled();
+        if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+            ImGui::SetTooltip("First 5 radix-2 stages via subgroup shuffles (texture backend, stage chain)");
+        ImGui::Checkbox("Fuse spectrum into FFT", &config.ocean.fused_spectrum);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Texture backend, radix-2 or single-dispatch only");
+        ImGui::BeginDisabled(!ocean.supports_incremental_phase());
+        ImGui::Checkbox("Incremental phase", &config.ocean.incremental_phase);
+        ImGui::EndDisabled();
+        if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+            ImGui::SetTooltip("Rotate stored phasors per frame instead of cos/sin(wt)");
+        ImGui::Checkbox("Half precision (f16)", &config.ocean.half_precision);
+        if (config.ocean.half_precision && !ocean.supports_shader_f16())
+            ImGui::TextDisabled("No shader-f16: buffer backend keeps f32 intermediates");
+        if (ImGui::Button("Precision report"))
+            precision_report = ocean.compare_precision(config, glfwGetTime());
+        if (precision_report.valid && ImGui::BeginTable("precision", 4, ImGuiTableFlags_Borders)) {
+            const char* names[3] = { "Height", "Disp X", "Disp Y" };
+            ImGui::TableSetupColumn("f16 - f32");
+            ImGui::TableSetupColumn("Max");
+            ImGui::TableSetupColumn("RMS");
+            ImGui::TableSetupColumn("Rel. RMS");
+            ImGui::TableHeadersRow();
+            for (int f = 0; f < 3; f++) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(names[f]);
+                ImGui::TableNextColumn(); ImGui::Text("%.2e", precision_report.max_abs[f]);
+                ImGui::TableNextColumn(); ImGui::Text("%.2e", precision_report.rms[f]);
+                ImGui::TableNextColumn(); ImGui::Text("%.3f%%", precision_report.rel_rms[f] * 100.f);
+            }
+            ImGui::EndTable();
+        }
+        ImGui::Checkbox("GPU spectrum", &config.ocean.gpu_spectrum);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Generate h0 and k-data in a compute pass instead of on the CPU + upload");
+        ImGui::Checkbox("Band pruning", &config.ocean.band_pruning);
+        ImGui::BeginDisabled(!config.ocean.band_pruning);
+        slider_on_release("Prune energy", &config.ocean.prune_energy, 1e-10f, 1e-3f, "%.0e",
+                          ImGuiSliderFlags_Logarithmic);
+        ImGui::EndDisabled();
+        if (ocean.band_pruned())
+            ImGui::TextDisabled("%u / %u rows occupied", ocean.occupied_rows(), ocean.size());
+        if (ocean.spectrum_pending())
+            ImGui::TextDisabled("Generating spectrum...");
+        ImGui::InputScalar("Seed", ImGuiDataType_U32, &config.ocean.seed);
+        ImGui::SameLine();
+        if (ImGui::Button("New seed"))
+            config.ocean.seed = std::random_device{}();
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("New random phases; parameter edits apply without it");
         ImGui::End();
     });
 
@@ -111,6 +329,66 @@ Application::Application(int w, int h)
         ImGui::SliderFloat("Threshold", &config.foam.threshold, 0.7f, 1.1f);
         ImGui::SliderFloat("Erosion",   &config.foam.erosion,   0.9f, 1.0f);
         ImGui::SliderFloat("Foam add",  &config.foam.foam_add,  0.f, 5.f);
+        ImGui::Checkbox("Analytic Jacobian", &config.foam.analytic_jacobian);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Transform an extra Jacobian channel instead of finite differences;\n"
+                              "compare the FFT and Foam rows in the Profiler panel");
+        ImGui::End();
+    });
+
+    /* One row per pass variant seen so far: switch backend / radix to fill in a comparison. */
+    ui_panels.push_back([this]() {
+        ImGui::Begin("Profiler");
+        ImGui::Text("Frame: %.2f ms", 1000.f / ImGui::GetIO().Framerate);
+        if (!profiler.enabled()) {
+            ImGui::TextDisabled("GPU timestamps not supported by this adapter");
+        } else if (ImGui::BeginTable("gpu_timings", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Pass");
+            ImGui::TableSetupColumn("GPU ms");
+            ImGui::TableSetupColumn("Samples");
+            ImGui::TableHeadersRow();
+            for (const GpuProfiler::Timing& t : profiler.timings()) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(t.name.c_str());
+                ImGui::TableNextColumn(); ImGui::Text("%.3f", t.avg_ms);
+                ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(t.samples));
+            }
+            ImGui::EndTable();
+            if (ImGui::Button("Reset timings"))
+                profiler.reset();
+        }
+        if (config.ocean.decimate_cascades)
+            ImGui::Text("Cascade updates: %.0f%% of full rate (FFT work per frame)",
+                        100.f * ocean.cascade_update_rate());
+        const char* kernels[TUNED_KERNELS] = { "Time spectrum", "FFT stages", "Foam" };
+        for (int k = 0; k < TUNED_KERNELS; k++) {
+            const WorkgroupShape wg = ocean.workgroup(static_cast<TunedKernel>(k));
+            ImGui::Text("%s workgroup: %ux%u%s", kernels[k], wg.x, wg.y,
+                        ocean.workgroup_tuned(static_cast<TunedKernel>(k)) ? " (tuned)" : "");
+        }
+        /* Ten passes over up to 4096 x 4096 take seconds, so they run off the render thread
+           like a spectrum build; the web build has no worker and runs them in place. */
+        if (jonswap_run.valid() && jonswap_run.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            jonswap_benchmark = jonswap_run.get();
+        ImGui::BeginDisabled(jonswap_run.valid());
+        if (ImGui::Button("JONSWAP benchmark")) {
+#ifdef __EMSCRIPTEN__
+            jonswap_benchmark = benchmark_jonswap(config.ocean, ocean.size(), config.ocean.patch_size);
+#else
+            jonswap_run = std::async(std::launch::async, benchmark_jonswap, config.ocean, ocean.size(),
+                                     config.ocean.patch_size);
+#endif
+        }
+        ImGui::EndDisabled();
+        if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+            ImGui::SetTooltip("Time the CPU spectrum's S(k) over one %ux%u grid: reference vs %s x%u batch",
+                              ocean.size(), ocean.size(), jonswap_isa(), jonswap_lanes());
+        if (jonswap_run.valid())
+            ImGui::TextDisabled("Benchmarking...");
+        else if (jonswap_benchmark.valid)
+            ImGui::Text("N = %u: %.2f ms scalar, %.2f ms batch (%.1fx), max error %.1e of peak",
+                        jonswap_benchmark.size, jonswap_benchmark.scalar_ms, jonswap_benchmark.batch_ms,
+                        jonswap_benchmark.scalar_ms / jonswap_benchmark.batch_ms, jonswap_benchmark.max_error);
         ImGui::End();
     });
 
@@ -153,7 +431,19 @@ void Application::main_loop()
 {
     glfwPollEvents();
 
-    foam_idx = ocean.tick(static_cast<float>(glfwGetTime()), config);
+    /* Resolution / precision / channel changes rebuild the simulation here, outside any
+       encoder that could still reference the old textures. */
+    fit_resolution(config);
+    const bool resized = config.ocean.fft_size != ocean.size();
+    if (resized || config.ocean.half_precision != ocean.half_precision()
+                || config.foam.analytic_jacobian != ocean.has_analytic_jacobian()
+                || config.ocean.cascades != ocean.cascade_count()) {
+        ocean.rebuild(config);
+        if (resized) renderer.rebuild_mesh(std::min(config.ocean.fft_size, MAX_MESH_SIZE));
+    }
+
+    profiler.begin_frame();
+    foam_idx = ocean.tick(glfwGetTime(), config);
     renderer.rebuild_bind_group(ocean, foam_idx);
 
     uniforms.eye_pos    = camera.eye();
@@ -163,9 +453,17 @@ void Application::main_loop()
         static_cast<float>(width) / static_cast<float>(height),
         0.01f, config.ocean.patch_size * 20.f);
     uniforms.model      = glm::scale(glm::mat4(1.f), glm::vec3(config.ocean.patch_size));
-    uniforms.N          = static_cast<float>(TEXTURE_SIZE);
+    uniforms.N          = static_cast<float>(ocean.size());
     uniforms.patch_size = config.ocean.patch_size;
     uniforms.lambda     = config.ocean.lambda;
+    uniforms.cascades   = ocean.cascade_count();
+    uniforms.foam_blend = ocean.foam_blend();
+    uniforms.layers     = { ocean.surface_layer(false), ocean.surface_layer(true),
+                            ocean.foam_layer(false),    ocean.foam_layer(true) };
+    for (uint32_t c = 0; c < ocean.cascade_count(); c++) {
+        uniforms.cascade_scale[c] = ocean.cascade_uv_scale(c);
+        uniforms.cascade_blend[c] = ocean.cascade_blend(c);
+    }
 
     TextureView target = get_next_surface_view();
     if (!target) return;
@@ -215,11 +513,15 @@ void Application::main_loop()
     pass.end();
     pass.release();
 
+    /* The ocean passes were submitted above; their queries resolve in this encoder. */
+    profiler.resolve(encoder);
+
     CommandBufferDescriptor cmd_desc = {};
     CommandBuffer command = encoder.finish(cmd_desc);
     encoder.release();
     queue.submit(1, &command);
     command.release();
+    profiler.end_frame();
 
     target.release();
 #ifndef __EMSCRIPTEN__
@@ -330,14 +632,23 @@ RequiredLimits Application::get_required_limits(Adapter adapter) const
     RequiredLimits limits = Default;
     limits.limits.maxVertexAttributes       = 3;
     limits.limits.maxVertexBuffers          = 1;
-    limits.limits.maxBufferSize             = static_cast<uint64_t>(MESH_SIZE) * MESH_SIZE * 6 * sizeof(uint32_t);
+    /* Sized for the largest selectable resolution so N can change without a new device, as far
+       as the adapter allows: at N = 4096 the spectrum buffer may not fit (see OceanSim::init_buffers). */
+    limits.limits.maxBufferSize             = std::min(std::max({
+        static_cast<uint64_t>(MAX_MESH_SIZE) * MAX_MESH_SIZE * 6 * sizeof(uint32_t),                   /* index buffer */
+        static_cast<uint64_t>(MAX_CASCADES) * MAX_FFT_SIZE * MAX_FFT_SIZE * 2 * sizeof(float),         /* phasor buffer */
+        static_cast<uint64_t>(MAX_CASCADES) * MAX_FFT_CHANNELS * MAX_FFT_SIZE * MAX_FFT_SIZE * 2 * sizeof(float) }),  /* spectrum buffer */
+        supported.limits.maxBufferSize);
+    limits.limits.maxStorageBufferBindingSize = std::min(
+        limits.limits.maxBufferSize, supported.limits.maxStorageBufferBindingSize);
     limits.limits.maxVertexBufferArrayStride = 5 * sizeof(float);
     limits.limits.maxBindGroups             = 2;
     limits.limits.maxUniformBuffersPerShaderStage = 1;
     limits.limits.maxUniformBufferBindingSize     = sizeof(RenderUniforms);
-    limits.limits.maxTextureDimension1D     = std::max({ width, height, TEXTURE_SIZE });
-    limits.limits.maxTextureDimension2D     = std::max({ width, height, TEXTURE_SIZE });
-    limits.limits.maxTextureArrayLayers     = 6;
+    limits.limits.maxTextureDimension1D     = std::max({ width, height, MAX_FFT_SIZE });
+    limits.limits.maxTextureDimension2D     = std::max({ width, height, MAX_FFT_SIZE });
+    /* Cubemap, FFT arrays and as many baked loop frames as the adapter allows. */
+    limits.limits.maxTextureArrayLayers     = std::max(MAX_CASCADES * MAX_FFT_CHANNELS, supported.limits.maxTextureArrayLayers);
     limits.limits.maxSampledTexturesPerShaderStage  = 6;
     limits.limits.maxStorageTexturesPerShaderStage  = 6;
     limits.limits.maxSamplersPerShaderStage         = 1;
@@ -347,5 +658,6 @@ RequiredLimits Application::get_required_limits(Adapter adapter) const
     limits.limits.maxComputeWorkgroupSizeY          = 16;
     limits.limits.maxComputeWorkgroupSizeZ          = 1;
     limits.limits.maxComputeInvocationsPerWorkgroup = 1024;
+    limits.limits.maxComputeWorkgroupStorageSize    = supported.limits.maxComputeWorkgroupStorageSize;
     return limits;
 }
@@ -0,0 +1,125 @@
+#include "GpuProfiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+using namespace wgpu;
+
+namespace {
+
+constexpr uint32_t QUERY_COUNT = 2 * GpuProfiler::MAX_SCOPES;
+constexpr uint64_t QUERY_BYTES = QUERY_COUNT * sizeof(uint64_t);
+constexpr double   SMOOTHING   = 0.05;   /* EMA weight of a new sample */
+
+} // namespace
+
+GpuProfiler::~GpuProfiler()
+{
+    if (!active) return;
+
+    query_set.destroy();
+    query_set.release();
+    resolve_buffer.destroy();
+    resolve_buffer.release();
+    readback_buffer.destroy();
+    readback_buffer.release();
+}
+
+void GpuProfiler::init(Device device)
+{
+    if (!device.hasFeature(FeatureName::TimestampQuery)) {
+        std::cout << "GpuProfiler: timestamp queries not supported, GPU timings disabled\n";
+        return;
+    }
+
+    QuerySetDescriptor qs_desc;
+    qs_desc.label = "Profiler timestamps";
+    qs_desc.type  = QueryType::Timestamp;
+    qs_desc.count = QUERY_COUNT;
+    query_set = device.createQuerySet(qs_desc);
+
+    BufferDescriptor buf_desc;
+    buf_desc.mappedAtCreation = false;
+    buf_desc.size             = QUERY_BYTES;
+
+    buf_desc.usage = BufferUsage::QueryResolve | BufferUsage::CopySrc;
+    resolve_buffer = device.createBuffer(buf_desc);
+
+    buf_desc.usage  = BufferUsage::MapRead | BufferUsage::CopyDst;
+    readback_buffer = device.createBuffer(buf_desc);
+
+    for (uint32_t i = 0; i < MAX_SCOPES; i++) {
+        writes[i].querySet                  = query_set;
+        writes[i].beginningOfPassWriteIndex = 2 * i;
+        writes[i].endOfPassWriteIndex       = 2 * i + 1;
+    }
+
+    active = true;
+}
+
+void GpuProfiler::begin_frame()
+{
+    frame_names.clear();
+    resolved = false;
+}
+
+const ComputePassTimestampWrites* GpuProfiler::scope(const std::string& name)
+{
+    if (!active || in_flight || frame_names.size() == MAX_SCOPES) return nullptr;
+
+    frame_names.push_back(name);
+    return &writes[frame_names.size() - 1];
+}
+
+void GpuProfiler::resolve(CommandEncoder encoder)
+{
+    if (!active || in_flight || frame_names.empty()) return;
+
+    const uint32_t count = static_cast<uint32_t>(frame_names.size()) * 2;
+    encoder.resolveQuerySet(query_set, 0, count, resolve_buffer, 0);
+    encoder.copyBufferToBuffer(resolve_buffer, 0, readback_buffer, 0, count * sizeof(uint64_t));
+    resolved = true;
+}
+
+void GpuProfiler::end_frame()
+{
+    if (!resolved) return;
+
+    in_flight     = true;
+    resolved      = false;
+    pending_names = frame_names;
+
+    const uint64_t size = pending_names.size() * 2 * sizeof(uint64_t);
+    map_callback = readback_buffer.mapAsync(MapMode::Read, 0, size, [this, size](BufferMapAsyncStatus status) {
+        if (status == BufferMapAsyncStatus::Success) {
+            std::vector<uint64_t> stamps(size / sizeof(uint64_t));
+            std::memcpy(stamps.data(), readback_buffer.getConstMappedRange(0, size), size);
+            readback_buffer.unmap();
+            accumulate(stamps.data());
+        }
+        in_flight = false;
+    });
+}
+
+void GpuProfiler::accumulate(const uint64_t* stamps)
+{
+    /* WebGPU timestamps are nanoseconds. A pass the driver reordered or that
+       straddled a counter reset shows end < begin; skip it rather than wrap. */
+    for (size_t i = 0; i < pending_names.size(); i++) {
+        const uint64_t begin = stamps[2 * i];
+        const uint64_t end   = stamps[2 * i + 1];
+        if (end < begin) continue;
+
+        const double ms = static_cast<double>(end - begin) * 1e-6;
+        auto it = std::find_if(results.begin(), results.end(),
+                               [&](const Timing& t) { return t.name == pending_names[i]; });
+        if (it == results.end()) {
+            results.push_back({ pending_names[i], ms, ms, 1 });
+            continue;
+        }
+        it->avg_ms += SMOOTHING * (ms - it->avg_ms);
+        it->last_ms = ms;
+        it->samples++;
+    }
+}
@@ -0,0 +1,291 @@
+#include "Jonswap.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#if defined(__AVX512F__)
+#  include <immintrin.h>
+#  define JONSWAP_AVX512
+#elif defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))   /* MSVC's /arch:AVX2 implies FMA */
+#  include <immintrin.h>
+#  define JONSWAP_AVX2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#  include <arm_neon.h>
+#  define JONSWAP_NEON
+#endif
+
+JonswapParams JonswapParams::from(const OceanConfig& ocean)
+{
+    const double g    = 9.81;
+    const double wind = std::sqrt(ocean.wind_x * ocean.wind_x + ocean.wind_y * ocean.wind_y);
+
+    JonswapParams p;
+    p.peak_freq   = static_cast<float>(22.0 * std::pow(g * g / (ocean.fetch * wind), 1.0 / 3.0));
+    p.alpha       = static_cast<float>(0.076 * std::pow(wind * wind / (ocean.fetch * g), 0.22));
+    p.enhancement = static_cast<float>(ocean.enhancement);
+    p.wind_dir[0] = static_cast<float>(ocean.wind_x / wind);
+    p.wind_dir[1] = static_cast<float>(ocean.wind_y / wind);
+    return p;
+}
+
+double jonswap(double pos_x, double pos_y,
+               double fetch, double wind_x, double wind_y,
+               double enhancement)
+{
+    using std::pow, std::exp, std::sqrt;
+
+    double freq = sqrt(pos_x * pos_x + pos_y * pos_y);
+    if (freq < 0.001) return 0.0;
+
+    double wind  = sqrt(wind_x * wind_x + wind_y * wind_y);
+    double g     = 9.81;
+    double freq_p = 22.0 * pow(pow(g, 2.0) / (fetch * wind), 1.0 / 3.0);
+    double alpha  = 0.076 * pow(pow(wind, 2.0) / (fetch * g), 0.22);
+    double sigma  = (freq <= freq_p) ? 0.07 : 0.09;
+    double r      = exp(-pow(freq - freq_p, 2.0) / (2.0 * pow(sigma * freq_p, 2.0)));
+
+    double cos_theta = (pos_x * wind_x + pos_y * wind_y) / (freq * wind);
+    double dir = std::max(0.0, cos_theta * cos_theta);
+
+    return alpha * (pow(g, 2.0) / pow(freq, 5.0))
+         * exp(-5.0 * pow(freq_p / freq, 4.0) / 4.0)
+         * pow(enhancement, r)
+         * dir * dir;
+}
+
+namespace {
+
+/* Lane types for jonswap_kernel: a register of W floats and the handful of operations the
+   kernel needs. less(a, b, x, y) is a < b ? x : y per lane; pow2i(n) is 2^n for n already
+   rounded to an integer in [-127, 127], with 2^-127 flushed to 0. */
+struct ScalarLanes {
+    using V = float;
+    static constexpr uint32_t W = 1;
+    static V    load(const float* p)          { return *p; }
+    static void store(float* p, V v)          { *p = v; }
+    static V    set(float x)                  { return x; }
+    static V    add(V a, V b)                 { return a + b; }
+    static V    sub(V a, V b)                 { return a - b; }
+    static V    mul(V a, V b)                 { return a * b; }
+    static V    div(V a, V b)                 { return a / b; }
+    static V    fma(V a, V b, V c)            { return a * b + c; }
+    static V    max(V a, V b)                 { return std::max(a, b); }
+    static V    sqrt(V a)                     { return std::sqrt(a); }
+    static V    round(V a)                    { return std::nearbyint(a); }
+    static V    less(V a, V b, V x, V y)      { return a < b ? x : y; }
+    static V    pow2i(V n)                    { return std::bit_cast<float>(static_cast<uint32_t>(static_cast<int32_t>(n) + 127) << 23); }
+};
+
+#if defined(JONSWAP_AVX512)
+/* GCC 12's AVX-512 headers seed masked intrinsics with a self-initialised
+   _mm512_undefined_ps(), which -Wmaybe-uninitialized flags at every inlined call. */
+#  if defined(__GNUC__) && !defined(__clang__)
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#  endif
+struct SimdLanes {
+    using V = __m512;
+    static constexpr uint32_t W = 16;
+    static constexpr const char* ISA = "AVX-512";
+    static V    load(const float* p)          { return _mm512_loadu_ps(p); }
+    static void store(float* p, V v)          { _mm512_storeu_ps(p, v); }
+    static V    set(float x)                  { return _mm512_set1_ps(x); }
+    static V    add(V a, V b)                 { return _mm512_add_ps(a, b); }
+    static V    sub(V a, V b)                 { return _mm512_sub_ps(a, b); }
+    static V    mul(V a, V b)                 { return _mm512_mul_ps(a, b); }
+    static V    div(V a, V b)                 { return _mm512_div_ps(a, b); }
+    static V    fma(V a, V b, V c)            { return _mm512_fmadd_ps(a, b, c); }
+    static V    max(V a, V b)                 { return _mm512_max_ps(a, b); }
+    static V    sqrt(V a)                     { return _mm512_sqrt_ps(a); }
+    static V    round(V a)                    { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static V    less(V a, V b, V x, V y)      { return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(a, b, _CMP_LT_OQ), y, x); }
+    static V    pow2i(V n)
+    {
+        const __m512i e = _mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127));
+        return _mm512_castsi512_ps(_mm512_slli_epi32(e, 23));
+    }
+};
+#  if defined(__GNUC__) && !defined(__clang__)
+#    pragma GCC diagnostic pop
+#  endif
+#elif defined(JONSWAP_AVX2)
+struct SimdLanes {
+    using V = __m256;
+    static constexpr uint32_t W = 8;
+    static constexpr const char* ISA = "AVX2";
+    static V    load(const float* p)          { return _mm256_loadu_ps(p); }
+    static void store(float* p, V v)          { _mm256_storeu_ps(p, v); }
+    static V    set(float x)                  { return _mm256_set1_ps(x); }
+    static V    add(V a, V b)                 { return _mm256_add_ps(a, b); }
+    static V    sub(V a, V b)                 { return _mm256_sub_ps(a, b); }
+    static V    mul(V a, V b)                 { return _mm256_mul_ps(a, b); }
+    static V    div(V a, V b)                 { return _mm256_div_ps(a, b); }
+    static V    fma(V a, V b, V c)            { return _mm256_fmadd_ps(a, b, c); }
+    static V    max(V a, V b)                 { return _mm256_max_ps(a, b); }
+    static V    sqrt(V a)                     { return _mm256_sqrt_ps(a); }
+    static V    round(V a)                    { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static V    less(V a, V b, V x, V y)      { return _mm256_blendv_ps(y, x, _mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+    static V    pow2i(V n)
+    {
+        const __m256i e = _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127));
+        return _mm256_castsi256_ps(_mm256_slli_epi32(e, 23));
+    }
+};
+#elif defined(JONSWAP_NEON)
+struct SimdLanes {
+    using V = float32x4_t;
+    static constexpr uint32_t W = 4;
+    static constexpr const char* ISA = "NEON";
+    static V    load(const float* p)          { return vld1q_f32(p); }
+    static void store(float* p, V v)          { vst1q_f32(p, v); }
+    static V    set(float x)                  { return vdupq_n_f32(x); }
+    static V    add(V a, V b)                 { return vaddq_f32(a, b); }
+    static V    sub(V a, V b)                 { return vsubq_f32(a, b); }
+    static V    mul(V a, V b)                 { return vmulq_f32(a, b); }
+    static V    div(V a, V b)                 { return vdivq_f32(a, b); }
+    static V    fma(V a, V b, V c)            { return vfmaq_f32(c, a, b); }
+    static V    max(V a, V b)                 { return vmaxq_f32(a, b); }
+    static V    sqrt(V a)                     { return vsqrtq_f32(a); }
+    static V    round(V a)                    { return vrndnq_f32(a); }
+    static V    less(V a, V b, V x, V y)      { return vbslq_f32(vcltq_f32(a, b), x, y); }
+    static V    pow2i(V n)
+    {
+        const int32x4_t e = vaddq_s32(vcvtnq_s32_f32(n), vdupq_n_s32(127));
+        return vreinterpretq_f32_s32(vshlq_n_s32(e, 23));
+    }
+};
+#else
+struct SimdLanes : ScalarLanes {
+    static constexpr const char* ISA = "scalar";
+};
+#endif
+
+/* 2^x for x <= 127: 2^round(x) from the exponent bits times a degree-6 Taylor polynomial
+   of 2^f on f in [-0.5, 0.5] (relative error < 2e-7). Below -126.5 the result is 0,
+   which is where the spectrum's exponentials vanish anyway. */
+template <typename L>
+typename L::V fast_exp2(typename L::V x)
+{
+    using V = typename L::V;
+    constexpr double ln2 = std::numbers::ln2;
+    x = L::max(x, L::set(-127.f));
+    const V n = L::round(x);
+    const V f = L::sub(x, n);
+    V p = L::set(static_cast<float>(ln2 * ln2 * ln2 * ln2 * ln2 * ln2 / 720.0));
+    p = L::fma(p, f, L::set(static_cast<float>(ln2 * ln2 * ln2 * ln2 * ln2 / 120.0)));
+    p = L::fma(p, f, L::set(static_cast<float>(ln2 * ln2 * ln2 * ln2 / 24.0)));
+    p = L::fma(p, f, L::set(static_cast<float>(ln2 * ln2 * ln2 / 6.0)));
+    p = L::fma(p, f, L::set(static_cast<float>(ln2 * ln2 / 2.0)));
+    p = L::fma(p, f, L::set(static_cast<float>(ln2)));
+    p = L::fma(p, f, L::set(1.f));
+    return L::mul(p, L::pow2i(n));
+}
+
+/* jonswap with the k-independent terms hoisted into `params`: one division, one sqrt and
+   three exp2 per lane instead of seven pow and two exp. Lanes with |k| < 0.001 give 0,
+   the rest divide by the clamped |k| so no lane produces inf or NaN. */
+template <typename L>
+void jonswap_kernel(const float* kx, const float* ky, float* out, size_t begin, size_t end,
+                    const JonswapParams& params)
+{
+    using V = typename L::V;
+    const float log2e = static_cast<float>(std::numbers::log2e);
+    const float fp    = params.peak_freq;
+
+    const V peak       = L::set(fp);
+    const V min_freq   = L::set(0.001f);
+    const V zero       = L::set(0.f);
+    const V inv_lo     = L::set(1.f / (0.07f * fp));   /* 1 / (σ k_p) below the peak */
+    const V inv_hi     = L::set(1.f / (0.09f * fp));   /* and above it */
+    const V r_scale    = L::set(-0.5f * log2e);
+    const V gamma_log2 = L::set(std::log2(params.enhancement));
+    const V tail_scale = L::set(-1.25f * log2e);
+    const V scale      = L::set(params.alpha * 9.81f * 9.81f);
+    const V wind_x     = L::set(params.wind_dir[0]);
+    const V wind_y     = L::set(params.wind_dir[1]);
+
+    for (size_t i = begin; i + L::W <= end; i += L::W) {
+        const V x     = L::load(kx + i);
+        const V y     = L::load(ky + i);
+        const V freq  = L::sqrt(L::fma(x, x, L::mul(y, y)));
+        const V inv_f = L::div(L::set(1.f), L::max(freq, min_freq));
+
+        const V d     = L::mul(L::sub(freq, peak), L::less(peak, freq, inv_hi, inv_lo));
+        const V r     = fast_exp2<L>(L::mul(r_scale, L::mul(d, d)));
+        const V gamma = fast_exp2<L>(L::mul(r, gamma_log2));
+
+        const V ratio  = L::mul(peak, inv_f);
+        const V ratio2 = L::mul(ratio, ratio);
+        const V tail   = fast_exp2<L>(L::mul(tail_scale, L::mul(ratio2, ratio2)));
+
+        const V inv_f2 = L::mul(inv_f, inv_f);
+        const V inv_f5 = L::mul(L::mul(inv_f2, inv_f2), inv_f);
+
+        const V cos_theta = L::mul(L::fma(x, wind_x, L::mul(y, wind_y)), inv_f);
+        const V dir       = L::mul(cos_theta, cos_theta);
+
+        const V s = L::mul(L::mul(L::mul(scale, inv_f5), L::mul(tail, gamma)), L::mul(dir, dir));
+        L::store(out + i, L::less(freq, min_freq, zero, s));
+    }
+}
+
+} // namespace
+
+void jonswap_batch(const float* kx, const float* ky, float* out, size_t n, const JonswapParams& params)
+{
+    const size_t body = n - n % SimdLanes::W;
+    jonswap_kernel<SimdLanes>(kx, ky, out, 0, body, params);
+    jonswap_kernel<ScalarLanes>(kx, ky, out, body, n, params);
+}
+
+const char* jonswap_isa()   { return SimdLanes::ISA; }
+uint32_t    jonswap_lanes() { return SimdLanes::W; }
+
+JonswapBenchmark benchmark_jonswap(const OceanConfig& ocean, uint32_t size, float patch_size)
+{
+    using clock = std::chrono::steady_clock;
+
+    const size_t texels = static_cast<size_t>(size) * size;
+    const int    N      = static_cast<int>(size);
+    std::vector<float> kx(texels), ky(texels), batch(texels);
+    std::vector<double> scalar(texels);
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            const float pi = static_cast<float>(std::numbers::pi);
+            kx[y * N + x] = 2.f * pi * ((x <= N / 2) ? x : x - N) / patch_size;
+            ky[y * N + x] = 2.f * pi * ((y <= N / 2) ? y : y - N) / patch_size;
+        }
+    }
+
+    /* Best of a few runs, so a preempted run does not count. */
+    auto best_ms = [](const auto& run) {
+        double best = 1e30;
+        for (int rep = 0; rep < 5; rep++) {
+            const clock::time_point start = clock::now();
+            run();
+            best = std::min(best, std::chrono::duration<double, std::milli>(clock::now() - start).count());
+        }
+        return best;
+    };
+
+    JonswapBenchmark result;
+    result.size      = size;
+    result.scalar_ms = best_ms([&]() {
+        for (size_t i = 0; i < texels; i++)
+            scalar[i] = jonswap(kx[i], ky[i], ocean.fetch, ocean.wind_x, ocean.wind_y, ocean.enhancement);
+    });
+    const JonswapParams params = JonswapParams::from(ocean);
+    result.batch_ms = best_ms([&]() { jonswap_batch(kx.data(), ky.data(), batch.data(), texels, params); });
+
+    const double peak = *std::max_element(scalar.begin(), scalar.end());
+    double max_error = 0.0;
+    for (size_t i = 0; i < texels; i++)
+        max_error = std::max(max_error, std::abs(batch[i] - scalar[i]));
+    result.max_error = peak > 0.0 ? static_cast<float>(max_error / peak) : 0.f;
+    result.valid     = true;
+    return result;
+}
@@ -1,14 +1,24 @@
 #include "OceanSim.h"
+#include "Jonswap.h"
 #include "ResourceManager.h"
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
 #include <cmath>
 #include <cstdio>
 #include <cstring>
+#include <iostream>
+#include <limits>
 #include <numbers>
-#include <random>
+#include <thread>
 #include <vector>
 
+#ifdef __EMSCRIPTEN__
+#  include <emscripten.h>
+#endif
+
 using namespace wgpu;
 using namespace pipeline_helpers;
 using namespace texture_helpers;
@@ -19,87 +29,239 @@ using namespace texture_helpers;
 
 namespace {
 
-double jonswap(double pos_x, double pos_y,
-               double fetch, double wind_x, double wind_y,
-               double enhancement = 3.3)
+/* Frame gaps longer than this (seconds) reseed the phasors exactly and restart the
+   cascade decimation schedule. */
+constexpr double MAX_PHASOR_STEP = 0.25;
+
+/* Runs body(begin, end) over [0, count) in contiguous chunks, one per hardware thread.
+   Callers make every item depend on its index only, so the result does not depend on the
+   split. Serial in the Emscripten build, which is linked without pthreads. */
+template <typename Body>
+void parallel_for(uint32_t count, const Body& body)
+{
+#ifdef __EMSCRIPTEN__
+    body(0u, count);
+#else
+    const uint32_t workers = std::max(1u, std::min(std::thread::hardware_concurrency(), count));
+    std::vector<std::jthread> threads;
+    threads.reserve(workers - 1);
+    for (uint32_t w = 1; w < workers; w++)
+        threads.emplace_back(body, count * w / workers, count * (w + 1) / workers);
+    body(0u, count / workers);
+#endif
+}
+
+/* Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"). Counter
+   based: the output is a pure function of counter and key, so texels can be drawn in
+   any order, on any number of threads, with bit-identical results. */
+std::array<uint32_t, 4> philox4x32(std::array<uint32_t, 4> ctr, std::array<uint32_t, 2> key)
 {
-    using std::pow, std::exp, std::sqrt;
+    for (int round = 0; round < 10; round++) {
+        const uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * ctr[0];
+        const uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * ctr[2];
+        ctr = { static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0], static_cast<uint32_t>(p1),
+                static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1], static_cast<uint32_t>(p0) };
+        key[0] += 0x9E3779B9u;
+        key[1] += 0xBB67AE85u;
+    }
+    return ctr;
+}
 
-    double freq = sqrt(pos_x * pos_x + pos_y * pos_y);
-    if (freq < 0.001) return 0.0;
+/* The two standard normal draws of spectrum texel `index` of a cascade: Box-Muller over
+   the first two Philox words of counter (index, cascade), keyed by OceanConfig::seed. */
+std::array<float, 2> texel_gaussians(uint32_t seed, uint32_t cascade, uint32_t index)
+{
+    const std::array<uint32_t, 4> bits = philox4x32({ index, cascade, 0u, 0u }, { seed, 0u });
+    const double u1     = (static_cast<double>(bits[0]) + 1.0) * 0x1p-32;   /* (0, 1]: log(u1) is finite */
+    const double u2     = static_cast<double>(bits[1]) * 0x1p-32;
+    const double radius = std::sqrt(-2.0 * std::log(u1));
+    const double angle  = 2.0 * std::numbers::pi * u2;
+    return { static_cast<float>(radius * std::cos(angle)), static_cast<float>(radius * std::sin(angle)) };
+}
 
-    double wind  = sqrt(wind_x * wind_x + wind_y * wind_y);
-    double g     = 9.81;
-    double freq_p = 22.0 * pow(pow(g, 2.0) / (fetch * wind), 1.0 / 3.0);
-    double alpha  = 0.076 * pow(pow(wind, 2.0) / (fetch * g), 0.22);
-    double sigma  = (freq <= freq_p) ? 0.07 : 0.09;
-    double r      = exp(-pow(freq - freq_p, 2.0) / (2.0 * pow(sigma * freq_p, 2.0)));
+/* texel_gaussians of every texel of one N × N cascade, in texel order: the GPU path's noise texture. */
+std::vector<float> gaussian_noise(uint32_t size, uint32_t seed, uint32_t cascade)
+{
+    std::vector<float> noise(2 * static_cast<size_t>(size) * size);
+    parallel_for(size, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin * size; i < end * size; i++) {
+            const std::array<float, 2> n = texel_gaussians(seed, cascade, i);
+            noise[2 * static_cast<size_t>(i)]     = n[0];
+            noise[2 * static_cast<size_t>(i) + 1] = n[1];
+        }
+    });
+    return noise;
+}
 
-    double cos_theta = (pos_x * wind_x + pos_y * wind_y) / (freq * wind);
-    double dir = std::max(0.0, cos_theta * cos_theta);
+struct TexelWave {
+    float kx, ky, k_len, omega;
+};
 
-    return alpha * (pow(g, 2.0) / pow(freq, 5.0))
-         * exp(-5.0 * pow(freq_p / freq, 4.0) / 4.0)
-         * pow(enhancement, r)
-         * dir * dir;
+/* Wavevector of texel (x, y) of an N × N grid over `patch_size` metres (indices above N/2
+   are negative frequencies) and its deep-water ω. With loop_period > 0, ω snaps to the
+   nearest multiple of 2π / T: every wave, and so the surface, repeats after T.
+   spectrum.wgsl evaluates the same in wave_vector and dispersion. */
+TexelWave texel_wave(int x, int y, int N, float patch_size, float loop_period)
+{
+    const int   kx_m = (x <= N / 2) ? x : x - N;
+    const int   ky_m = (y <= N / 2) ? y : y - N;
+    const float pi   = static_cast<float>(std::numbers::pi);
+
+    TexelWave w;
+    w.kx    = 2.f * pi * kx_m / patch_size;
+    w.ky    = 2.f * pi * ky_m / patch_size;
+    w.k_len = std::sqrt(w.kx * w.kx + w.ky * w.ky);
+    w.omega = std::sqrt(9.81f * w.k_len);
+    if (loop_period > 0.f) {
+        const float step = 2.f * pi / loop_period;
+        w.omega = std::round(w.omega / step) * step;
+    }
+    return w;
 }
 
-void generate_spectrum(const SimulationConfig& config,
+/* h0(k) and k-data of one N × N cascade over `patch_size` metres, with the random amplitudes
+   of texel_gaussians. Only |k| in [k_min, k_max) gets energy. Amplitudes carry Δk relative
+   to config.ocean.patch_size, so cascades of different sizes describe the same sea and
+   cascade 0 matches a single-patch ocean.
+   Each Hermitian pair is visited once, from the texel with the larger linear index, which
+   draws for both: rows N/2 + 1 .. N - 1 in full and the self-mirrored rows 0 and N/2 from
+   their larger half. A row and its mirror belong to one such owner row, so owner rows
+   are split across threads without two threads writing the same texel. */
+void generate_spectrum(const SimulationConfig& config, uint32_t size, uint32_t cascade,
+                       float patch_size, double k_min, double k_max,
                        std::vector<float>& spectrum, std::vector<float>& k_data)
 {
-    const int   N          = static_cast<int>(TEXTURE_SIZE);
-    const float patch_size = config.ocean.patch_size;
+    const int    N         = static_cast<int>(size);
+    const double amplitude = config.ocean.wave_amplitude * config.ocean.patch_size / patch_size;
+    const float  period    = config.ocean.loop ? config.ocean.loop_period : 0.f;
 
     spectrum.assign(N * N * 4, 0.f);
     k_data.assign(N * N * 4, 0.f);
 
-    std::mt19937 gen{ std::random_device{}() };
-    std::normal_distribution<double> dist{ 0.0, 1.0 };
-
-    for (int ky = 0; ky < N; ky++) {
-        for (int kx = 0; kx < N; kx++) {
-            int i  = kx + ky * N;
-            int sx = (N - kx) % N;
-            int sy = (N - ky) % N;
-            int j  = sx + sy * N;
-
-            int kx_m = (kx <= N / 2) ? kx : kx - N;
-            int ky_m = (ky <= N / 2) ? ky : ky - N;
-
-            float kx_phys = 2.f * static_cast<float>(std::numbers::pi) * kx_m / patch_size;
-            float ky_phys = 2.f * static_cast<float>(std::numbers::pi) * ky_m / patch_size;
-            float k_len   = std::sqrt(kx_phys * kx_phys + ky_phys * ky_phys);
-            float omega   = std::sqrt(9.81f * k_len);
-
-            k_data[4 * i + 0] = kx_phys;
-            k_data[4 * i + 1] = ky_phys;
-            k_data[4 * i + 2] = omega;
-            k_data[4 * i + 3] = k_len;
-
-            k_data[4 * j + 0] = -kx_phys;
-            k_data[4 * j + 1] = -ky_phys;
-            k_data[4 * j + 2] = omega;
-            k_data[4 * j + 3] = k_len;
-
-            double scale = std::sqrt(jonswap(kx_phys, ky_phys,
-                                             config.ocean.fetch,
-                                             config.ocean.wind_x,
-                                             config.ocean.wind_y,
-                                             config.ocean.enhancement) * 0.5)
-                         * config.ocean.wave_amplitude;
-            float re = static_cast<float>(dist(gen) * scale);
-            float im = static_cast<float>(dist(gen) * scale);
-
-            if (i == j) {
-                spectrum[4 * i]     = re;
-                spectrum[4 * i + 1] = 0.f;
-            } else {
+    /* Owner row r: 0 for r == 0, N/2 + r - 1 after it. S(k) goes a row at a time through
+       jonswap_batch; rows 0 and N/2 evaluate a few texels they do not own. */
+    const JonswapParams params = JonswapParams::from(config.ocean);
+    parallel_for(size / 2 + 1, [&](uint32_t begin, uint32_t end) {
+        std::vector<TexelWave> row_waves(size);
+        std::vector<float>     row_kx(size), row_ky(size), row_s(size);
+        for (uint32_t r = begin; r < end; r++) {
+            const int ky = r == 0 ? 0 : N / 2 + static_cast<int>(r) - 1;
+            for (int kx = 0; kx < N; kx++) {
+                row_waves[kx] = texel_wave(kx, ky, N, patch_size, period);
+                row_kx[kx]    = row_waves[kx].kx;
+                row_ky[kx]    = row_waves[kx].ky;
+            }
+            jonswap_batch(row_kx.data(), row_ky.data(), row_s.data(), size, params);
+
+            for (int kx = 0; kx < N; kx++) {
+                int i  = kx + ky * N;
+                int sx = (N - kx) % N;
+                int sy = (N - ky) % N;
+                int j  = sx + sy * N;
+                if (i < j) continue;   /* the larger half of rows 0 and N/2 owns the pair */
+
+                const TexelWave& w = row_waves[kx];
+
+                k_data[4 * i + 0] = w.kx;
+                k_data[4 * i + 1] = w.ky;
+                k_data[4 * i + 2] = w.omega;
+                k_data[4 * i + 3] = w.k_len;
+
+                const bool in_band = w.k_len >= k_min && w.k_len < k_max;
+                double scale = !in_band ? 0.0 : std::sqrt(row_s[kx] * 0.5) * amplitude;
+                const std::array<float, 2> n = texel_gaussians(config.ocean.seed, cascade, static_cast<uint32_t>(i));
+                float re = static_cast<float>(n[0] * scale);
+                float im = static_cast<float>(n[1] * scale);
+
+                if (i == j) {
+                    spectrum[4 * i]     = re;
+                    spectrum[4 * i + 1] = 0.f;
+                    continue;
+                }
                 spectrum[4 * i]     = re;
                 spectrum[4 * i + 1] = im;
                 spectrum[4 * j]     = re;
                 spectrum[4 * j + 1] = -im;
+
+                k_data[4 * j + 0] = -w.kx;
+                k_data[4 * j + 1] = -w.ky;
+                k_data[4 * j + 2] = w.omega;
+                k_data[4 * j + 3] = w.k_len;
+            }
+        }
+    });
+}
+
+/* Band pruning: zeroes every h0 texel whose energy |h0|² is below `threshold` × the
+   peak and fills `table` as the fft.wgsl prune binding expects ([0, N) row mask,
+   then the occupied row list). |h0(k)| = |h0(-k)|, so the mask stays Hermitian.
+   `spectrum` holds `layers` cascades; the kernels share one table, so a row is
+   occupied when it is in any of them. A threshold of 0 keeps everything.
+   Returns the number of occupied rows. */
+uint32_t prune_bands(std::vector<float>& spectrum, uint32_t size, uint32_t layers, float threshold,
+                     std::vector<uint32_t>& table)
+{
+    const size_t texels = static_cast<size_t>(size) * size * layers;
+    float peak = 0.f;
+    for (size_t t = 0; t < texels; t++)
+        peak = std::max(peak, spectrum[4 * t] * spectrum[4 * t] + spectrum[4 * t + 1] * spectrum[4 * t + 1]);
+
+    const float cutoff = threshold * peak;
+    table.assign(2 * static_cast<size_t>(size), 0u);
+    uint32_t rows = 0;
+    for (uint32_t y = 0; y < size; y++) {
+        bool live = false;
+        for (uint32_t layer = 0; layer < layers; layer++) {
+            for (uint32_t x = 0; x < size; x++) {
+                float* h0 = &spectrum[4 * ((static_cast<size_t>(layer) * size + y) * size + x)];
+                if (threshold > 0.f && h0[0] * h0[0] + h0[1] * h0[1] < cutoff) {
+                    h0[0] = 0.f;
+                    h0[1] = 0.f;
+                }
+                live |= h0[0] != 0.f || h0[1] != 0.f;
             }
         }
+        /* An all-zero grid still needs one row so the dispatches stay non-empty. */
+        if (live || (y == size - 1 && rows == 0)) {
+            table[y]             = 1u;
+            table[size + rows++] = y;
+        }
+    }
+    return rows;
+}
+
+/* Radix sequence for the Stockham stage chain: as many `radix` stages as fit
+   in log2n, then a radix-4 and/or radix-2 tail for the leftover bits. */
+std::vector<uint32_t> radix_plan(uint32_t log2n, uint32_t radix)
+{
+    const uint32_t bits = static_cast<uint32_t>(std::countr_zero(radix));
+    std::vector<uint32_t> plan(log2n / bits, radix);
+    const uint32_t rest = log2n % bits;
+    if (rest == 2) plan.push_back(4);
+    if (rest == 1) plan.push_back(2);
+    return plan;
+}
+
+void end_pass(ComputePassEncoder pass)
+{
+    pass.end();
+#ifndef WEBGPU_BACKEND_WGPU
+    wgpuComputePassEncoderRelease(pass);
+#endif
+}
+
+/* Pumps the device until an async callback has set `done`. Native backends poll;
+   the Emscripten build yields to the browser (it links with ASYNCIFY). */
+void wait_until([[maybe_unused]] Device device, const bool& done)
+{
+    while (!done) {
+#if defined(WEBGPU_BACKEND_DAWN)
+        device.tick();
+#elif defined(WEBGPU_BACKEND_WGPU)
+        device.poll(true);
+#elif defined(__EMSCRIPTEN__)
+        emscripten_sleep(1);
+#endif
     }
 }
 
@@ -111,34 +273,33 @@ void generate_spectrum(const SimulationConfig& config,
 
 OceanSim::~OceanSim()
 {
+    release_resources();
+}
+
+void OceanSim::release_resources()
+{
+    /* The map callback writes live_rows: let a readback in flight finish before its buffer goes. */
+    wait_until(device, rows_idle);
+    /* A spectrum build in flight has the old size and cascade count: let it finish, unused. */
+    if (spectrum_build.valid())
+        spectrum_build.wait();
+    spectrum_build = {};
+    release_loop();
     for (int i = 0; i < 2; i++) {
-        height_texture_views[i].release();
-        height_textures[i].destroy();
-        height_textures[i].release();
-        slope_x_texture_views[i].release();
-        slope_x_textures[i].destroy();
-        slope_x_textures[i].release();
-        slope_y_texture_views[i].release();
-        slope_y_textures[i].destroy();
-        slope_y_textures[i].release();
-        disp_x_texture_views[i].release();
-        disp_x_textures[i].destroy();
-        disp_x_textures[i].release();
-        disp_y_texture_views[i].release();
-        disp_y_textures[i].destroy();
-        disp_y_textures[i].release();
+        fft_texture_views[i].release();
+        fft_textures[i].destroy();
+        fft_textures[i].release();
         foam_texture_views[i].release();
+        foam_array_views[i].release();
         foam_textures[i].destroy();
         foam_textures[i].release();
-        h_fft_bind_groups[i].release();
-        sx_fft_bind_groups[i].release();
-        sy_fft_bind_groups[i].release();
-        dx_fft_bind_groups[i].release();
-        dy_fft_bind_groups[i].release();
+        fft_bind_groups[i].release();
         foam_bind_groups[i].release();
     }
 
     time_spectrum_bind_group.release();
+    buffer_bind_group.release();
+    h0_bind_group.release();
 
     spectrum_texture_view.release();
     spectrum_texture.destroy();
@@ -152,45 +313,296 @@ OceanSim::~OceanSim()
     k_data_texture.destroy();
     k_data_texture.release();
 
+    noise_texture_view.release();
+    noise_texture.destroy();
+    noise_texture.release();
+
+    displacement_texture_view.release();
+    displacement_texture.destroy();
+    displacement_texture.release();
+    slope_texture_view.release();
+    slope_texture.destroy();
+    slope_texture.release();
+    surface_sampler.release();
+
     time_spectrum_bgl.release();
     time_spectrum_layout.release();
     fft_bgl.release();
     fft_layout.release();
     foam_bgl.release();
     foam_layout.release();
-
+    buffer_bgl.release();
+    buffer_layout.release();
+    h0_bgl.release();
+    h0_layout.release();
+
+    spectrum_buffer.destroy();
+    spectrum_buffer.release();
+    prune_buffer.destroy();
+    prune_buffer.release();
+    phasor_buffer.destroy();
+    phasor_buffer.release();
     compute_uniform_buffer.release();
     foam_uniform_buffer.release();
+    h0_uniform_buffer.release();
+    h0_stats_buffer.destroy();
+    h0_stats_buffer.release();
+    rows_readback_buffer.destroy();
+    rows_readback_buffer.release();
+    rows_wanted = false;
+
+    /* The tuned families are re-specialised in place by autotune(), so they are nulled. */
+    for (ComputePipeline* p : { &time_spectrum_pipeline, &fft_h_pipeline, &fft_v_pipeline,
+                                &fft_h_fused_pipeline, &foam_pipeline, &foam_spectral_pipeline }) {
+        if (*p) p->release();
+        *p = nullptr;
+    }
+    if (fft_h_shared_pipeline) fft_h_shared_pipeline.release();
+    if (fft_v_shared_pipeline) fft_v_shared_pipeline.release();
+    fft_h_shared_pipeline = nullptr;
+    fft_v_shared_pipeline = nullptr;
+    if (fft_h_fused_shared_pipeline) fft_h_fused_shared_pipeline.release();
+    fft_h_fused_shared_pipeline = nullptr;
+    if (fft_h_subgroup_pipeline)       fft_h_subgroup_pipeline.release();
+    if (fft_v_subgroup_pipeline)       fft_v_subgroup_pipeline.release();
+    if (fft_h_fused_subgroup_pipeline) fft_h_fused_subgroup_pipeline.release();
+    fft_h_subgroup_pipeline       = nullptr;
+    fft_v_subgroup_pipeline       = nullptr;
+    fft_h_fused_subgroup_pipeline = nullptr;
+    for (auto& direction : fft_four_step_pipelines)
+        for (auto& step : direction)
+            step.release();
+    fft_resolve_pipeline.release();
+    fft_transpose_pipeline.release();
+    fft_resolve_transposed_pipeline.release();
+    for (int i = 0; i < 3; i++) {
+        fft_h_radix_pipelines[i].release();
+        fft_v_radix_pipelines[i].release();
+    }
 
-    time_spectrum_pipeline.release();
-    fft_h_pipeline.release();
-    fft_v_pipeline.release();
-    foam_pipeline.release();
+    time_spectrum_buffer_pipeline.release();
+    fft_h_buffer_pipeline.release();
+    fft_v_buffer_pipeline.release();
+    if (fft_h_buffer_shared_pipeline) fft_h_buffer_shared_pipeline.release();
+    if (fft_v_buffer_shared_pipeline) fft_v_buffer_shared_pipeline.release();
+    fft_h_buffer_shared_pipeline = nullptr;
+    fft_v_buffer_shared_pipeline = nullptr;
+    resolve_buffer_pipeline.release();
+    h0_measure_pipeline.release();
+    h0_generate_pipeline.release();
+    h0_rows_pipeline.release();
 }
 
 // ---------------------------------------------------------------------------
 // Public API
 // ---------------------------------------------------------------------------
 
-void OceanSim::init(wgpu::Device d, wgpu::Queue q, const SimulationConfig& config)
+void OceanSim::init(wgpu::Device d, wgpu::Queue q, const SimulationConfig& config,
+                    GpuProfiler* p, TuningCache* t, const SpectrumCache* spectra)
+{
+    device         = d;
+    queue          = q;
+    profiler       = p;
+    tuning         = t;
+    spectrum_cache = spectra;
+
+    create_resources(config);
+#ifdef WEBGPU_BACKEND_DAWN
+    if (has_subgroups && !verify_subgroups(config)) {
+        std::cout << "OceanSim: subgroup butterflies disagree with the radix-2 chain, disabled\n";
+        subgroups_failed = true;
+        has_subgroups    = false;
+    }
+#endif
+}
+
+void OceanSim::rebuild(const SimulationConfig& config)
+{
+    release_resources();
+    create_resources(config);
+}
+
+uint64_t OceanSim::resource_bytes(const SimulationConfig& config)
 {
-    device = d;
-    queue  = q;
+    const uint64_t cascades = std::clamp(config.ocean.cascades, 1u, MAX_CASCADES);
+    const uint64_t layers   = cascades * (config.foam.analytic_jacobian ? MAX_FFT_CHANNELS : BASE_FFT_CHANNELS);
+    const uint64_t texel    = config.ocean.half_precision ? 4 * sizeof(uint16_t) : 4 * sizeof(float);
+
+    /* Per N × N texel: FFT ping-pong, displacement and slope with their decimation layers,
+       two foam buffers, h0, k-data, noise, the spectrum buffer and the phasors. */
+    const uint64_t per_texel = 2 * layers * texel
+                             + 2 * 2 * cascades * texel
+                             + 2 * sizeof(float)
+                             + cascades * (texel + 4 * sizeof(float) + 2 * sizeof(float))
+                             + layers * 2 * sizeof(float)
+                             + cascades * 2 * sizeof(float);
+    return static_cast<uint64_t>(config.ocean.fft_size) * config.ocean.fft_size * per_texel;
+}
 
+void OceanSim::create_resources(const SimulationConfig& config)
+{
+    fft_size   = config.ocean.fft_size;
+    fft_log    = static_cast<uint32_t>(std::countr_zero(fft_size));
+    foam_frame = 0;
+
+    /* New output textures: the first tick updates every cascade. */
+    std::fill(std::begin(intervals), std::end(intervals), 0u);
+    schedule_reset = true;
+    update_rate    = 1.0f;
+
+    has_shader_f16 = device.hasFeature(FeatureName::ShaderF16);
+#ifdef WEBGPU_BACKEND_DAWN
+    has_subgroups  = device.hasFeature(SUBGROUP_FEATURE) && !subgroups_failed;
+#endif
+    half           = config.ocean.half_precision;
+    half_buffer    = half && has_shader_f16;
+    storage_format = half ? TextureFormat::RGBA16Float : TextureFormat::RGBA32Float;
+
+    analytic_jacobian = config.foam.analytic_jacobian;
+    fft_channels      = analytic_jacobian ? MAX_FFT_CHANNELS : BASE_FFT_CHANNELS;
+    cascades          = std::clamp(config.ocean.cascades, 1u, MAX_CASCADES);
+    fft_layers        = fft_channels * cascades;
+
+    load_workgroups();
     init_pipelines();
     init_buffers();
-    init_textures(config);
+    init_textures();
     init_bind_groups();
+    upload_spectrum(config);   /* the GPU path dispatches through the bind groups */
+    autotune();
+}
+
+int OceanSim::tick(double time, const SimulationConfig& config)
+{
+    /* Spectrum edits: a new amplitude only rescales h0 in the kernels; anything that changes
+       its shape (including the loop's ω grid) regenerates it with the same seed. CPU work
+       runs on a worker while the old spectrum keeps animating, and the result is uploaded
+       at the start of a later tick; edits made meanwhile start the next build after that. */
+    if (spectrum_build.valid() && spectrum_build.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        apply_spectrum(spectrum_build.get());
+    if (!spectrum_build.valid() && classify_change(config.ocean) == SpectrumChange::Regenerate)
+        request_spectrum(config);
+    if (rows_wanted && rows_idle)
+        read_row_count();
+    /* A zero-amplitude spectrum cannot be rescaled; the pending rebuild takes the new one. */
+    amplitude_scale = spectrum_config.wave_amplitude != 0.0
+        ? static_cast<float>(config.ocean.wave_amplitude / spectrum_config.wave_amplitude)
+        : 1.f;
+
+    /* Until the loop's ω grid is applied (a build in flight, or quantised_period still 0 when
+       Loop was just turned on), the live simulation runs: a bake now would record the old
+       spectrum, and the playback position divides by the period. */
+    loop_playing = config.ocean.loop && loop_limit >= 2
+                && !spectrum_build.valid() && quantised_period > 0.f;
+    if (!loop_playing) {
+        release_loop();
+        return simulate(time, config);
+    }
+
+    /* Playback encodes no GPU work: the renderer reads the two baked frames either side of
+       `time` and blends them. The baked frames carry the amplitude, so a new one rebakes. */
+    if (loop_baked && loop_amplitude != amplitude_scale) release_loop();
+    if (!loop_baked) bake_loop(config);
+    const double position = std::fmod(std::max(time, 0.0), static_cast<double>(quantised_period))
+                          / quantised_period * loop_frames;
+    const double frame    = std::floor(position);
+    loop_frame[0] = static_cast<uint32_t>(frame) % loop_frames;
+    loop_frame[1] = (loop_frame[0] + 1) % loop_frames;
+    loop_blend    = static_cast<float>(position - frame);
+    return 0;
 }
 
-int OceanSim::tick(float time, const SimulationConfig& config)
+int OceanSim::simulate(double time, const SimulationConfig& config)
 {
-    /* Pre-fill all TEXTURE_LOG uniform slots so each FFT stage dispatch can
-       select its slot via a dynamic offset within a single compute pass. */
-    std::vector<uint8_t> ubuf(compute_uniform_stride * TEXTURE_LOG, 0);
-    for (unsigned s = 0; s < TEXTURE_LOG; s++) {
-        FourierUniforms cu{ time, static_cast<uint32_t>(s), TEXTURE_SIZE, TEXTURE_LOG };
+    /* The first frame, pauses, clock jumps and a new decimation plan restart the schedule. */
+    double dt = last_time < 0.0 ? 0.0 : time - last_time;
+    const bool jump = last_time < 0.0 || dt < 0.0 || dt > MAX_PHASOR_STEP;
+    last_time = time;
+    if (plan_cascades(config) || jump) {
+        schedule_reset = true;
+        dt = 0.0;
+    }
+
+    /* Incremental phase: every spectrum consumer rotates its texel's stored phasor by
+       e^{iω·step}, step = time since its cascade's last update. Reseed exactly on the CPU
+       after a spectrum upload, when the mode is switched on, and on a schedule restart,
+       where one huge step would need many rotor squarings (and turn phasor drift into a
+       visible jump anyway). */
+    const bool phasor_mode = config.ocean.incremental_phase && phasor_fits;
+    if (!phasor_mode)
+        phasors_live = false;
+    else if (!phasors_live || schedule_reset) {
+        seed_phasors(time);
+        schedule_reset = true;
+    }
+    schedule_cascades(time, dt);
+
+    /* Halve the rotor angle until ω_max·step <= 0.25 rad, the range phase_rotor is exact in. */
+    double step = 0.0;
+    for (uint32_t c = 0; c < cascades; c++)
+        if (active_mask & (1u << c)) step = std::max(step, evolved_time[c] - previous_time[c]);
+    uint32_t halvings = 0;
+    while (halvings < 16 && omega_max * step > 0.25 * static_cast<double>(1u << halvings)) halvings++;
+
+    const bool single_dispatch = shared_fft && config.ocean.single_dispatch;
+    const bool buffer_backend  = config.ocean.backend == FftBackend::Buffer && buffer_fits;
+
+    /* Four-step replaces the stage chain of the texture backend, whatever the radix. */
+    four_step_chain = !single_dispatch && !buffer_backend && config.ocean.four_step;
+
+    /* The buffer backend's in-place stages are radix-2 DIT only. */
+    const bool stockham = !single_dispatch && !buffer_backend && !four_step_chain
+                       && config.ocean.radix != FftRadix::Radix2;
+    stage_radices = stockham
+        ? radix_plan(fft_log, 2u << static_cast<int>(config.ocean.radix))
+        : std::vector<uint32_t>{};
+
+    char label[64];
+    if (single_dispatch)
+        snprintf(label, sizeof(label), "FFT %s single-dispatch N=%u",
+                 buffer_backend ? "buffer" : "texture", fft_size);
+    else if (four_step_chain)
+        snprintf(label, sizeof(label), "FFT texture four-step %ux%u N=%u",
+                 four_step_m[1], four_step_m[0], fft_size);
+    else
+        snprintf(label, sizeof(label), "FFT %s radix-%u N=%u",
+                 buffer_backend ? "buffer" : "texture",
+                 stockham ? stage_radices.front() : 2u, fft_size);
+    /* The Stockham radix-4/8 and four-step chains and the buffer backend keep the separate spectrum pass. */
+    const bool fused = config.ocean.fused_spectrum && !buffer_backend && !stockham && !four_step_chain;
+    if (fused) strncat(label, " fused", sizeof(label) - strlen(label) - 1);
+    /* The subgroup prologue replaces the first stages of the texture radix-2 chain only. */
+    subgroup_chain = has_subgroups && config.ocean.subgroups && !single_dispatch && !buffer_backend
+                  && !stockham && !four_step_chain;
+    if (subgroup_chain) strncat(label, " subgroup", sizeof(label) - strlen(label) - 1);
+    /* The Stockham and four-step chains keep their own column kernels. */
+    transposed_chain = config.ocean.transposed_vertical && !buffer_backend && !stockham && !four_step_chain;
+    if (transposed_chain) strncat(label, " transposed", sizeof(label) - strlen(label) - 1);
+    if (analytic_jacobian) strncat(label, " +jacobian", sizeof(label) - strlen(label) - 1);
+    if (phasor_mode) strncat(label, " phasor", sizeof(label) - strlen(label) - 1);
+    /* Its own row: the average against the full-rate row is the amortised saving. */
+    if (std::any_of(intervals, intervals + cascades, [](uint32_t i) { return i > 1; }))
+        strncat(label, " decimated", sizeof(label) - strlen(label) - 1);
+    fft_scope = label;
+
+    /* Pre-fill all fft_log uniform slots so each FFT stage dispatch can
+       select its slot via a dynamic offset within a single compute pass.
+       The Stockham chain has at most fft_log stages, so it shares the slots. */
+    std::vector<uint8_t> ubuf(compute_uniform_stride * fft_log * 2, 0);
+    uint32_t ns = 1;
+    for (unsigned s = 0; s < 2 * fft_log; s++) {
+        /* Second bank: the row-only pipeline's horizontal pass over all N transposed rows. */
+        const bool second = s >= fft_log;
+        FourierUniforms cu{ static_cast<float>(time), static_cast<uint32_t>(s % fft_log), fft_size, fft_log, ns,
+                            second ? fft_size : live_rows,
+                            static_cast<float>(dt), halvings, phasor_mode ? 1u : 0u, cascades, active_mask, amplitude_scale,
+                            {}, {} };
+        for (uint32_t c = 0; c < cascades; c++) {
+            cu.cascade_time[c] = static_cast<float>(evolved_time[c]);
+            cu.cascade_dt[c]   = static_cast<float>(evolved_time[c] - previous_time[c]);
+        }
         std::memcpy(ubuf.data() + s * compute_uniform_stride, &cu, sizeof(FourierUniforms));
+        if (s < stage_radices.size()) ns *= stage_radices[s];
     }
     queue.writeBuffer(compute_uniform_buffer, 0, ubuf.data(), ubuf.size());
 
@@ -198,81 +610,32 @@ int OceanSim::tick(float time, const SimulationConfig& config)
         config.ocean.lambda,
         config.foam.threshold,
         config.foam.erosion,
-        static_cast<float>(TEXTURE_SIZE),
+        static_cast<float>(fft_size),
         config.foam.foam_add,
-        0.f, 0.f, 0.f};
+        config.ocean.patch_size / static_cast<float>(fft_size),
+        cascades, 0.f, {}, {}};
+    for (uint32_t c = 0; c < cascades; c++) {
+        fu.cascade_scale[c] = cascade_uv_scale(c);
+        fu.cascade_blend[c] = blend[c];
+    }
     queue.writeBuffer(foam_uniform_buffer, 0, &fu, sizeof(FoamUniforms));
 
     CommandEncoder encoder = device.createCommandEncoder(CommandEncoderDescriptor{});
     encoder.pushDebugGroup("OceanSim::tick");
+    encode_previous_copy(encoder);
 
-    ComputePassDescriptor pass_desc;
-    pass_desc.timestampWrites = nullptr;
-    ComputePassEncoder pass   = encoder.beginComputePass(pass_desc);
-
-    /* timeSpectrum: evolve h0(k) → h(k,t) and compute slope + displacement spectra. */
-    pass.pushDebugGroup("Time Spectrum");
-    pass.setPipeline(time_spectrum_pipeline);
-    pass.setBindGroup(0, time_spectrum_bind_group, 0, nullptr);
-    pass.dispatchWorkgroups(TEXTURE_SIZE / 16, TEXTURE_SIZE / 16, 1);
-    pass.popDebugGroup();
-
-    /* Horizontal IFFT for all 5 channels, TEXTURE_LOG stages each. */
-    pass.pushDebugGroup("FFT Horizontal");
-    pass.setPipeline(fft_h_pipeline);
-    for (unsigned s = 0; s < TEXTURE_LOG; s++) {
-        char buf[32];
-        snprintf(buf, sizeof(buf), "Stage %u", s);
-        pass.pushDebugGroup(buf);
-        uint32_t off = static_cast<uint32_t>(s) * compute_uniform_stride;
-        pass.setBindGroup(0, h_fft_bind_groups [1 - s % 2], 1, &off);
-        pass.dispatchWorkgroups(TEXTURE_SIZE / 2 / 16, TEXTURE_SIZE / 16, 1);
-        pass.setBindGroup(0, sx_fft_bind_groups[1 - s % 2], 1, &off);
-        pass.dispatchWorkgroups(TEXTURE_SIZE / 2 / 16, TEXTURE_SIZE / 16, 1);
-        pass.setBindGroup(0, sy_fft_bind_groups[1 - s % 2], 1, &off);
-        pass.dispatchWorkgroups(TEXTURE_SIZE / 2 / 16, TEXTURE_SIZE / 16, 1);
-        pass.setBindGroup(0, dx_fft_bind_groups[1 - s % 2], 1, &off);
-        pass.dispatchWorkgroups(TEXTURE_SIZE / 2 / 16, TEXTURE_SIZE / 16, 1);
-        pass.setBindGroup(0, dy_fft_bind_groups[1 - s % 2], 1, &off);
-        pass.dispatchWorkgroups(TEXTURE_SIZE / 2 / 16, TEXTURE_SIZE / 16, 1);
-        pass.popDebugGroup();
-    }
-    pass.popDebugGroup();
-
-    /* Vertical IFFT — transposed dispatch, offset ping-pong index by TEXTURE_LOG. */
-    pass.pushDebugGroup("FFT Vertical");
-    pass.setPipeline(fft_v_pipeline);
-    for (unsigned s = 0; s < TEXTURE_LOG; s++) {
-        char buf[32];
-        snprintf(buf, sizeof(buf), "Stage %u", s);
-        pass.pushDebugGroup(buf);
-        uint32_t off = static_cast<uint32_t>(s) * compute_uniform_stride;
-        int bg = (TEXTURE_LOG + s + 1) % 2;
-        pass.setBindGroup(0, h_fft_bind_groups [bg], 1, &off);
-        pass.dispatchWorkgroups(TEXTURE_SIZE / 16, TEXTURE_SIZE / 2 / 16, 1);
-        pass.setBindGroup(0, sx_fft_bind_groups[bg], 1, &off);
-        pass.dispatchWorkgroups(TEXTURE_SIZE / 16, TEXTURE_SIZE / 2 / 16, 1);
-        pass.setBindGroup(0, sy_fft_bind_groups[bg], 1, &off);
-        pass.dispatchWorkgroups(TEXTURE_SIZE / 16, TEXTURE_SIZE / 2 / 16, 1);
-        pass.setBindGroup(0, dx_fft_bind_groups[bg], 1, &off);
-        pass.dispatchWorkgroups(TEXTURE_SIZE / 16, TEXTURE_SIZE / 2 / 16, 1);
-        pass.setBindGroup(0, dy_fft_bind_groups[bg], 1, &off);
-        pass.dispatchWorkgroups(TEXTURE_SIZE / 16, TEXTURE_SIZE / 2 / 16, 1);
-        pass.popDebugGroup();
-    }
-    pass.popDebugGroup();
+    if (buffer_backend)
+        encode_buffer_fft(encoder, single_dispatch);
+    else
+        encode_texture_fft(encoder, single_dispatch, fused);
 
     /* Foam: mark breaking pixels (J < threshold), erode previous accumulation. */
-    pass.pushDebugGroup("Foam");
-    pass.setPipeline(foam_pipeline);
+    ComputePassEncoder pass = begin_pass(encoder, analytic_jacobian ? "Foam spectral" : "Foam finite-diff");
+    pass.setPipeline(analytic_jacobian ? foam_spectral_pipeline : foam_pipeline);
     pass.setBindGroup(0, foam_bind_groups[foam_frame % 2], 0, nullptr);
-    pass.dispatchWorkgroups(TEXTURE_SIZE / 16, TEXTURE_SIZE / 16, 1);
-    pass.popDebugGroup();
-
-    pass.end();
-#ifndef WEBGPU_BACKEND_WGPU
-    wgpuComputePassEncoderRelease(pass);
-#endif
+    const WorkgroupShape foam_wg = workgroups[static_cast<int>(TunedKernel::Foam)];
+    pass.dispatchWorkgroups(fft_size / foam_wg.x, fft_size / foam_wg.y, 1);
+    end_pass(pass);
 
     encoder.popDebugGroup();
     CommandBuffer commands = encoder.finish(CommandBufferDescriptor{});
@@ -287,31 +650,695 @@ int OceanSim::tick(float time, const SimulationConfig& config)
     return foam_read_idx;
 }
 
-void OceanSim::rebuild_spectrum(const SimulationConfig& config)
+void OceanSim::bake_loop(const SimulationConfig& config)
 {
-    upload_spectrum(config);
+    release_loop();
+
+    /* Frame f holds the output at f · T / frames: cascades layers of displacement and slope,
+       one layer of foam. */
+    loop_frames = std::clamp(config.ocean.loop_frames, 2u, loop_limit);
+
+    const WGPUTextureUsageFlags loop_usage = TextureUsage::TextureBinding | TextureUsage::CopyDst;
+    loop_disp_texture  = create_texture_2d_array(device, fft_size, fft_size, loop_frames * cascades,
+                                                 storage_format, loop_usage);
+    loop_disp_view     = create_view_2d_array(loop_disp_texture, storage_format, loop_frames * cascades);
+    loop_slope_texture = create_texture_2d_array(device, fft_size, fft_size, loop_frames * cascades,
+                                                 storage_format, loop_usage);
+    loop_slope_view    = create_view_2d_array(loop_slope_texture, storage_format, loop_frames * cascades);
+    loop_foam_texture  = create_texture_2d_array(device, fft_size, fft_size, loop_frames,
+                                                 TextureFormat::R32Float, loop_usage);
+    loop_foam_view     = create_view_2d_array(loop_foam_texture, TextureFormat::R32Float, loop_frames);
+
+    auto copy_layers = [&](CommandEncoder encoder, Texture from, uint32_t from_layer,
+                           Texture to, uint32_t to_layer, uint32_t layers) {
+        ImageCopyTexture src = {};
+        src.texture  = from;
+        src.mipLevel = 0;
+        src.origin   = { 0, 0, from_layer };
+        src.aspect   = TextureAspect::All;
+        ImageCopyTexture dst = src;
+        dst.texture  = to;
+        dst.origin   = { 0, 0, to_layer };
+        encoder.copyTextureToTexture(src, dst, Extent3D{ fft_size, fft_size, layers });
+    };
+
+    /* Two passes over the period: the first lets the foam accumulation settle into its
+       periodic state, the second records. Every cascade runs every frame, and nothing is
+       timed: the profiler expects a handful of passes per frame, not a whole period. */
+    SimulationConfig bake_config = config;
+    bake_config.ocean.decimate_cascades = false;
+    GpuProfiler* timed = profiler;
+    profiler  = nullptr;
+    last_time = -1.0;
+    for (int pass = 0; pass < 2; pass++) {
+        for (uint32_t f = 0; f < loop_frames; f++) {
+            const int foam_idx = simulate(static_cast<double>(quantised_period) * f / loop_frames, bake_config);
+            if (pass == 0) continue;
+
+            CommandEncoder encoder = device.createCommandEncoder(CommandEncoderDescriptor{});
+            copy_layers(encoder, displacement_texture, 0, loop_disp_texture, f * cascades, cascades);
+            copy_layers(encoder, slope_texture, 0, loop_slope_texture, f * cascades, cascades);
+            copy_layers(encoder, foam_textures[foam_idx], 0, loop_foam_texture, f, 1);
+            CommandBuffer commands = encoder.finish(CommandBufferDescriptor{});
+            queue.submit(commands);
+#ifndef WEBGPU_BACKEND_WGPU
+            wgpuCommandBufferRelease(commands);
+            wgpuCommandEncoderRelease(encoder);
+#endif
+        }
+    }
+    profiler  = timed;
+    last_time = -1.0;   /* the live simulation restarts its schedule after playback */
+    loop_baked     = true;
+    loop_amplitude = amplitude_scale;
+
+    std::cout << "Loop: " << loop_frames << " frames over " << quantised_period << " s baked, "
+              << loop_frames * loop_frame_bytes / (1024 * 1024) << " MiB\n";
+}
+
+void OceanSim::release_loop()
+{
+    for (Texture* texture : { &loop_disp_texture, &loop_slope_texture, &loop_foam_texture }) {
+        if (!*texture) continue;
+        texture->destroy();
+        texture->release();
+        *texture = nullptr;
+    }
+    for (TextureView* view : { &loop_disp_view, &loop_slope_view, &loop_foam_view }) {
+        if (*view) view->release();
+        *view = nullptr;
+    }
+    loop_baked = false;
+}
+
+bool OceanSim::plan_cascades(const SimulationConfig& config)
+{
+    uint32_t next[MAX_CASCADES] = {};
+    for (uint32_t c = 0; c < cascades; c++)
+        next[c] = config.ocean.decimate_cascades
+            ? std::clamp(config.ocean.cascade_interval[c], 1u, MAX_CASCADE_INTERVAL)
+            : 1u;
+    if (std::equal(next, next + cascades, intervals))
+        return false;
+    std::copy(next, next + cascades, intervals);
+
+    /* Spread the updates over the frames: shortest interval first, each cascade takes the
+       phase whose update frames are least loaded so far, over one period of all intervals. */
+    static_assert(MAX_CASCADE_INTERVAL <= 4, "PERIOD must be a multiple of every interval");
+    constexpr uint32_t PERIOD = 12;
+    uint32_t load[PERIOD] = {};
+    uint32_t order[MAX_CASCADES];
+    for (uint32_t c = 0; c < cascades; c++) order[c] = c;
+    std::stable_sort(order, order + cascades, [&](uint32_t a, uint32_t b) { return intervals[a] < intervals[b]; });
+
+    for (uint32_t i = 0; i < cascades; i++) {
+        const uint32_t c = order[i];
+        uint32_t best_peak = std::numeric_limits<uint32_t>::max(), best_sum = best_peak;
+        for (uint32_t p = 0; p < intervals[c]; p++) {
+            uint32_t peak = 0, sum = 0;
+            for (uint32_t f = 0; f < PERIOD; f++) {
+                if ((f + p) % intervals[c] != 0) continue;
+                peak = std::max(peak, load[f]);
+                sum += load[f];
+            }
+            if (peak < best_peak || (peak == best_peak && sum < best_sum)) {
+                best_peak = peak;
+                best_sum  = sum;
+                phases[c] = p;
+            }
+        }
+        for (uint32_t f = 0; f < PERIOD; f++)
+            if ((f + phases[c]) % intervals[c] == 0) load[f]++;
+    }
+    return true;
+}
+
+void OceanSim::schedule_cascades(double time, double dt)
+{
+    /* A cascade due this frame is evolved to the time of the last frame before its next
+       update, (interval - 1) frames ahead, and its old result becomes the previous layer.
+       Until the next update the frame time then lies between the two, and the renderer
+       blends from one to the other. Both are exact samples of the analytic phase, so only
+       the blend in between is approximate, and only for the slow cascades that are worth
+       decimating. On a restart every cascade is evolved to `time` and shown unblended. */
+    active_mask = 0;
+    for (uint32_t c = 0; c < cascades; c++) {
+        if (!schedule_reset && (schedule_frame + phases[c]) % intervals[c] != 0) continue;
+        active_mask |= 1u << c;
+        if (schedule_reset) evolved_time[c] = time;
+        previous_time[c] = evolved_time[c];
+        evolved_time[c]  = schedule_reset ? time : time + (intervals[c] - 1) * dt;
+    }
+    for (uint32_t c = 0; c < cascades; c++) {
+        const double span = evolved_time[c] - previous_time[c];
+        blend[c] = span > 0.0
+            ? static_cast<float>(std::clamp((time - previous_time[c]) / span, 0.0, 1.0))
+            : 1.0f;
+    }
+    schedule_reset = false;
+    schedule_frame++;
+
+    const float rate = static_cast<float>(std::popcount(active_mask)) / static_cast<float>(cascades);
+    update_rate += 0.05f * (rate - update_rate);
+}
+
+void OceanSim::encode_previous_copy(wgpu::CommandEncoder encoder)
+{
+    /* Decimated cascades due this frame keep their current output as the previous layer.
+       The others skip the copy: they are shown unblended (span 0 or interval 1). */
+    for (uint32_t c = 0; c < cascades; c++) {
+        if (!(active_mask & (1u << c)) || blend[c] >= 1.0f) continue;
+        for (Texture texture : { displacement_texture, slope_texture }) {
+            ImageCopyTexture src = {};
+            src.texture  = texture;
+            src.mipLevel = 0;
+            src.origin   = { 0, 0, c };
+            src.aspect   = TextureAspect::All;
+            ImageCopyTexture dst = src;
+            dst.origin   = { 0, 0, cascades + c };
+            encoder.copyTextureToTexture(src, dst, Extent3D{ fft_size, fft_size, 1 });
+        }
+    }
+}
+
+SpectrumChange OceanSim::classify_change(const OceanConfig& ocean) const
+{
+    const OceanConfig& s = spectrum_config;
+    if (ocean.patch_size != s.patch_size || ocean.cascade_scale != s.cascade_scale
+        || ocean.wind_x != s.wind_x || ocean.wind_y != s.wind_y
+        || ocean.fetch != s.fetch || ocean.enhancement != s.enhancement
+        || ocean.band_pruning != s.band_pruning || ocean.prune_energy != s.prune_energy
+        || ocean.gpu_spectrum != s.gpu_spectrum || ocean.seed != s.seed
+        || ocean.loop != s.loop || (ocean.loop && ocean.loop_period != s.loop_period))
+        return SpectrumChange::Regenerate;
+    /* Pruning cuts relative to the peak, so it is amplitude-invariant. A zero amplitude
+       leaves nothing to rescale. */
+    if (ocean.wave_amplitude != s.wave_amplitude)
+        return s.wave_amplitude != 0.0 ? SpectrumChange::Amplitude : SpectrumChange::Regenerate;
+    return SpectrumChange::None;
+}
+
+PrecisionReport OceanSim::compare_precision(const SimulationConfig& config, double time)
+{
+    PrecisionReport report;
+
+    /* Two private simulations on this device, with this grid and seed: [0] f32, [1] f16. */
+    std::vector<float> output[2];
+    for (int p = 0; p < 2; p++) {
+        SimulationConfig probe_config = config;
+        probe_config.ocean.fft_size       = fft_size;
+        probe_config.ocean.half_precision = (p == 1);
+        probe_config.foam.analytic_jacobian = analytic_jacobian;
+        probe_config.ocean.cascades         = cascades;
+        probe_config.ocean.loop             = false;
+
+        OceanSim probe;
+        probe.device = device;
+        probe.queue  = queue;
+        probe.create_resources(probe_config);
+        probe.tick(time, probe_config);
+        if (!probe.read_output(output[p])) {
+            std::cerr << "OceanSim: precision readback failed\n";
+            return report;
+        }
+    }
+
+    /* Field f: component of the RGBA displacement readback (dx, dy, h). */
+    const int    field_comp[3] = { 2, 0, 1 };
+    const size_t texels        = static_cast<size_t>(fft_size) * fft_size;
+
+    for (int f = 0; f < 3; f++) {
+        double err_sq = 0.0, sig_sq = 0.0, max_abs = 0.0;
+        for (size_t t = 0; t < texels; t++) {
+            const size_t idx = t * 4 + field_comp[f];
+            const double ref = output[0][idx];
+            const double err = std::abs(output[1][idx] - ref);
+            err_sq += err * err;
+            sig_sq += ref * ref;
+            max_abs = std::max(max_abs, err);
+        }
+        report.max_abs[f] = static_cast<float>(max_abs);
+        report.rms[f]     = static_cast<float>(std::sqrt(err_sq / texels));
+        report.rel_rms[f] = sig_sq > 0.0 ? static_cast<float>(std::sqrt(err_sq / sig_sq)) : 0.f;
+    }
+    report.valid = true;
+
+    const char* names[3] = { "height", "disp-x", "disp-y" };
+    std::cout << "f16 vs f32 at N=" << fft_size << ":\n";
+    for (int f = 0; f < 3; f++)
+        std::cout << "  " << names[f] << ": max " << report.max_abs[f] << ", rms " << report.rms[f]
+                  << " (" << report.rel_rms[f] * 100.f << "% of signal)\n";
+    return report;
+}
+
+/* The subgroup extension is experimental in Dawn, so its kernels are checked once on this
+   device before use: the fused and plain horizontal prologues and the vertical one, against
+   the same spectrum through the plain radix-2 chain. A module the compiler rejects leaves
+   its probe's output empty, which fails the same way. */
+bool OceanSim::verify_subgroups(const SimulationConfig& config)
+{
+    SimulationConfig probe_config = config;
+    probe_config.ocean.fft_size            = 256;
+    probe_config.ocean.half_precision      = false;
+    probe_config.ocean.cascades            = 1;
+    probe_config.ocean.loop                = false;
+    probe_config.ocean.decimate_cascades   = false;
+    probe_config.ocean.backend             = FftBackend::Texture;
+    probe_config.ocean.single_dispatch     = false;
+    probe_config.ocean.four_step           = false;
+    probe_config.ocean.radix               = FftRadix::Radix2;
+
+    /* [0] reference, [1] fused horizontal + vertical prologue, [2] plain horizontal, also
+       run over the transposed columns. */
+    std::vector<float> output[3];
+    for (int p = 0; p < 3; p++) {
+        probe_config.ocean.subgroups           = p > 0;
+        probe_config.ocean.fused_spectrum      = p == 1;
+        probe_config.ocean.transposed_vertical = p == 2;
+
+        OceanSim probe;
+        probe.device = device;
+        probe.queue  = queue;
+        probe.create_resources(probe_config);
+        probe.tick(1.0, probe_config);
+        if (!probe.read_output(output[p])) return false;
+    }
+
+    for (int p = 1; p < 3; p++) {
+        double err_sq = 0.0, sig_sq = 0.0;
+        for (size_t i = 0; i < output[0].size(); i++) {
+            const double err = output[p][i] - output[0][i];
+            err_sq += err * err;
+            sig_sq += static_cast<double>(output[0][i]) * output[0][i];
+        }
+        if (!(sig_sq > 0.0) || err_sq > 1e-8 * sig_sq) return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Private: output readback (precision report)
+// ---------------------------------------------------------------------------
+
+bool OceanSim::read_output(std::vector<float>& out)
+{
+    /* RGBA texels; rows are N × 8 or N × 16 bytes, a multiple of 256 for every N >= 64. */
+    const uint32_t texel_bytes = static_cast<uint32_t>(half ? 4 * sizeof(uint16_t) : 4 * sizeof(float));
+    const uint32_t row_bytes   = fft_size * texel_bytes;
+    const uint64_t size        = static_cast<uint64_t>(row_bytes) * fft_size;
+
+    SupportedLimits supported;
+    device.getLimits(&supported);
+    if (size > supported.limits.maxBufferSize) {
+        std::cerr << "OceanSim: N=" << fft_size << " readback exceeds maxBufferSize\n";
+        return false;
+    }
+
+    BufferDescriptor buf_desc;
+    buf_desc.mappedAtCreation = false;
+    buf_desc.size             = size;
+    buf_desc.usage            = BufferUsage::CopyDst | BufferUsage::MapRead;
+    Buffer readback = device.createBuffer(buf_desc);
+
+    ImageCopyTexture src = {};
+    src.texture  = displacement_texture;
+    src.mipLevel = 0;
+    src.origin   = { 0, 0, 0 };
+    src.aspect   = TextureAspect::All;
+    ImageCopyBuffer dst = {};
+    dst.buffer              = readback;
+    dst.layout.offset       = 0;
+    dst.layout.bytesPerRow  = row_bytes;
+    dst.layout.rowsPerImage = fft_size;
+    Extent3D extent = { fft_size, fft_size, 1 };
+
+    CommandEncoder encoder = device.createCommandEncoder(CommandEncoderDescriptor{});
+    encoder.copyTextureToBuffer(src, dst, extent);
+    CommandBuffer commands = encoder.finish(CommandBufferDescriptor{});
+    queue.submit(commands);
+#ifndef WEBGPU_BACKEND_WGPU
+    wgpuCommandBufferRelease(commands);
+    wgpuCommandEncoderRelease(encoder);
+#endif
+
+    bool done = false, ok = false;
+    auto callback = readback.mapAsync(MapMode::Read, 0, size, [&](BufferMapAsyncStatus status) {
+        ok   = status == BufferMapAsyncStatus::Success;
+        done = true;
+    });
+    wait_until(device, done);
+
+    if (ok) {
+        const void* mapped = readback.getConstMappedRange(0, size);
+        if (half) {
+            const uint16_t* h = static_cast<const uint16_t*>(mapped);
+            out.resize(size / sizeof(uint16_t));
+            std::transform(h, h + out.size(), out.begin(), half_to_float);
+        } else {
+            out.resize(size / sizeof(float));
+            std::memcpy(out.data(), mapped, size);
+        }
+        readback.unmap();
+    }
+    readback.destroy();
+    readback.release();
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Private: FFT encoding (one per backend; both end in the displacement / slope textures)
+// ---------------------------------------------------------------------------
+
+ComputePassEncoder OceanSim::begin_pass(wgpu::CommandEncoder encoder, const std::string& name)
+{
+    ComputePassDescriptor pass_desc;
+    pass_desc.label           = name.c_str();
+    pass_desc.timestampWrites = profiler ? profiler->scope(name) : nullptr;
+    return encoder.beginComputePass(pass_desc);
+}
+
+void OceanSim::encode_texture_fft(wgpu::CommandEncoder encoder, bool single_dispatch, bool fused)
+{
+    ComputePassEncoder pass;
+    if (!fused) {
+        /* timeSpectrum: evolve h0(k) → h(k,t) and emit packed slope + displacement spectra. */
+        pass = begin_pass(encoder, "Time Spectrum");
+        const WorkgroupShape ts_wg = workgroups[static_cast<int>(TunedKernel::Spectrum)];
+        pass.setPipeline(time_spectrum_pipeline);
+        pass.setBindGroup(0, time_spectrum_bind_group, 0, nullptr);
+        pass.dispatchWorkgroups(fft_size / ts_wg.x, fft_size / ts_wg.y, cascades);
+        end_pass(pass);
+    }
+
+    pass = begin_pass(encoder, fft_scope);
+    const WorkgroupShape wg = workgroups[static_cast<int>(TunedKernel::FftStage)];
+
+    /* One dispatch covers every channel of every cascade: z selects the texture-array layer.
+       The kernels that gather all channels of a texel (fused, resolve) take z = cascade. */
+    auto dispatch_channels = [&](int bg, uint32_t off, uint32_t x, uint32_t y) {
+        pass.setBindGroup(0, fft_bind_groups[bg], 1, &off);
+        pass.dispatchWorkgroups(x, y, fft_layers);
+    };
+
+    if (single_dispatch) {
+        /* One workgroup per row, then per column: [0] → [1] → [0], same final texture
+           as the stage chain below. Slot 0 carries log2n; stage is unused here. */
+        pass.pushDebugGroup("FFT Horizontal");
+        if (fused) {
+            /* Evolves and transforms every channel of a row in one workgroup: z = cascade. */
+            uint32_t off = 0;
+            pass.setPipeline(fft_h_fused_shared_pipeline);
+            pass.setBindGroup(0, fft_bind_groups[1], 1, &off);
+            pass.dispatchWorkgroups(1, live_rows, cascades);
+        } else {
+            pass.setPipeline(fft_h_shared_pipeline);
+            dispatch_channels(1, 0, 1, live_rows);
+        }
+        pass.popDebugGroup();
+
+        if (transposed_chain) {
+            encode_columns_as_rows(pass, true, 1);
+        } else {
+            /* The vertical kernel loops over the channels itself and writes the output
+               textures, so it runs once per column and cascade and fft[0] is never written. */
+            uint32_t off = 0;
+            pass.pushDebugGroup("FFT Vertical");
+            pass.setPipeline(fft_v_shared_pipeline);
+            pass.setBindGroup(0, fft_bind_groups[0], 1, &off);
+            pass.dispatchWorkgroups(fft_size, 1, cascades);
+            pass.popDebugGroup();
+        }
+    } else if (four_step_chain) {
+        /* Two dispatches per direction, [0] → [1] → [0] like the single-dispatch path.
+           Step one runs N1 sub-FFTs of length N2 per line, step two N2 of length N1. */
+        const uint32_t sub_ffts[2] = { four_step_m[1], four_step_m[0] };
+        const char*    dirs[2]     = { "FFT Horizontal", "FFT Vertical" };
+        const uint32_t lines[2]    = { live_rows, fft_size };
+        for (int d = 0; d < 2; d++) {
+            pass.pushDebugGroup(dirs[d]);
+            for (int step = 0; step < 2; step++) {
+                pass.setPipeline(fft_four_step_pipelines[d][step]);
+                dispatch_channels(1 - step, 0, sub_ffts[step] / FOUR_STEP_LINES, lines[d]);
+            }
+            pass.popDebugGroup();
+        }
+    } else if (!stage_radices.empty()) {
+        /* Stockham chain: P = stage_radices.size() dispatches per direction. Same
+           ping-pong parity rule as the radix-2 chain with fft_log replaced by P,
+           so the result still lands in fft[0]. Not band-pruned: every row is transformed
+           (the pruned rows are zero, so the output is the same). */
+        const uint32_t stages = static_cast<uint32_t>(stage_radices.size());
+        auto groups = [](uint32_t n) { return (n + 15) / 16; };
+
+        pass.pushDebugGroup("FFT Horizontal");
+        for (uint32_t s = 0; s < stages; s++) {
+            const uint32_t radix = stage_radices[s];
+            pass.setPipeline(fft_h_radix_pipelines[std::countr_zero(radix) - 1]);
+            dispatch_channels((s + 1) % 2, s * compute_uniform_stride,
+                              groups(fft_size / radix), fft_size / 16);
+        }
+        pass.popDebugGroup();
+
+        pass.pushDebugGroup("FFT Vertical");
+        for (uint32_t s = 0; s < stages; s++) {
+            const uint32_t radix = stage_radices[s];
+            pass.setPipeline(fft_v_radix_pipelines[std::countr_zero(radix) - 1]);
+            dispatch_channels((stages + s + 1) % 2, s * compute_uniform_stride,
+                              fft_size / 16, groups(fft_size / radix));
+        }
+        pass.popDebugGroup();
+    } else {
+        /* Horizontal IFFT for all packed channels at once, fft_log stages, over the
+           occupied spectrum rows only (band pruning). */
+        const uint32_t row_groups = (live_rows + wg.y - 1) / wg.y;
+        pass.pushDebugGroup("FFT Horizontal");
+        unsigned first = 0;
+        if (subgroup_chain) {
+            /* Stages [0, SUBGROUP_STAGES) in one dispatch. The count is odd, so it reads and
+               writes the same ping-pong pair as its first and last stage would: bind group 1. */
+            static_assert(SUBGROUP_STAGES % 2 == 1);
+            const uint32_t sg_rows = (live_rows + 7) / 8;
+            pass.pushDebugGroup("Stages 0-4 (subgroup)");
+            if (fused) {
+                uint32_t off = 0;
+                pass.setPipeline(fft_h_fused_subgroup_pipeline);
+                pass.setBindGroup(0, fft_bind_groups[1], 1, &off);
+                pass.dispatchWorkgroups(fft_size / 32, sg_rows, cascades);
+            } else {
+                pass.setPipeline(fft_h_subgroup_pipeline);
+                dispatch_channels(1, 0, fft_size / 32, sg_rows);
+            }
+            pass.popDebugGroup();
+            first = SUBGROUP_STAGES;
+        } else if (fused) {
+            /* Stage 0 evolves the spectrum and writes all channels itself: z = cascade. */
+            uint32_t off = 0;
+            pass.pushDebugGroup("Stage 0 (fused)");
+            pass.setPipeline(fft_h_fused_pipeline);
+            pass.setBindGroup(0, fft_bind_groups[1], 1, &off);
+            pass.dispatchWorkgroups(fft_size / 2 / wg.x, row_groups, cascades);
+            pass.popDebugGroup();
+            first = 1;
+        }
+        pass.setPipeline(fft_h_pipeline);
+        for (unsigned s = first; s < fft_log; s++) {
+            char buf[32];
+            snprintf(buf, sizeof(buf), "Stage %u", s);
+            pass.pushDebugGroup(buf);
+            uint32_t off = static_cast<uint32_t>(s) * compute_uniform_stride;
+            dispatch_channels(1 - s % 2, off, fft_size / 2 / wg.x, row_groups);
+            pass.popDebugGroup();
+        }
+        pass.popDebugGroup();
+
+        if (transposed_chain) {
+            /* The horizontal chain leaves its result in fft[fft_log % 2]. */
+            encode_columns_as_rows(pass, false, static_cast<int>(fft_log % 2));
+        } else {
+            /* Vertical IFFT — transposed dispatch, offset ping-pong index by fft_log. */
+            pass.pushDebugGroup("FFT Vertical");
+            first = 0;
+            if (subgroup_chain) {
+                pass.pushDebugGroup("Stages 0-4 (subgroup)");
+                pass.setPipeline(fft_v_subgroup_pipeline);
+                dispatch_channels((fft_log + 1) % 2, 0, fft_size / 32, fft_size / 8);
+                pass.popDebugGroup();
+                first = SUBGROUP_STAGES;
+            }
+            pass.setPipeline(fft_v_pipeline);
+            for (unsigned s = first; s < fft_log; s++) {
+                char buf[32];
+                snprintf(buf, sizeof(buf), "Stage %u", s);
+                pass.pushDebugGroup(buf);
+                uint32_t off = static_cast<uint32_t>(s) * compute_uniform_stride;
+                dispatch_channels((fft_log + s + 1) % 2, off, fft_size / wg.x, fft_size / 2 / wg.y);
+                pass.popDebugGroup();
+            }
+            pass.popDebugGroup();
+        }
+    }
+
+    if (!single_dispatch && !transposed_chain) {
+        /* The stage chains leave every channel in fft[0]; bind group 1 reads it. */
+        uint32_t off = 0;
+        pass.pushDebugGroup("Resolve");
+        pass.setPipeline(fft_resolve_pipeline);
+        pass.setBindGroup(0, fft_bind_groups[1], 1, &off);
+        pass.dispatchWorkgroups(fft_size / 16, fft_size / 16, cascades);
+        pass.popDebugGroup();
+    }
+
+    end_pass(pass);
+}
+
+/* Vertical IFFT as rows: tiled transpose of fft[cur], the horizontal kernels again over
+   all N rows (second uniform bank), and a resolve that reads the result transposed back,
+   so no pass strides down columns. Each dispatch reads fft[cur] and writes fft[1 - cur]. */
+void OceanSim::encode_columns_as_rows(wgpu::ComputePassEncoder pass, bool single_dispatch, int cur)
+{
+    auto dispatch = [&](uint32_t slot, uint32_t x, uint32_t y, uint32_t z) {
+        uint32_t off = slot * compute_uniform_stride;
+        pass.setBindGroup(0, fft_bind_groups[1 - cur], 1, &off);
+        pass.dispatchWorkgroups(x, y, z);
+        cur = 1 - cur;
+    };
+
+    pass.pushDebugGroup("FFT Transpose");
+    pass.setPipeline(fft_transpose_pipeline);
+    dispatch(0, fft_size / 16, fft_size / 16, fft_layers);
+    pass.popDebugGroup();
+
+    pass.pushDebugGroup("FFT Vertical (as rows)");
+    if (single_dispatch) {
+        pass.setPipeline(fft_h_shared_pipeline);
+        dispatch(fft_log, 1, fft_size, fft_layers);
+    } else {
+        unsigned first = 0;
+        if (subgroup_chain) {
+            pass.setPipeline(fft_h_subgroup_pipeline);
+            dispatch(fft_log, fft_size / 32, fft_size / 8, fft_layers);
+            first = SUBGROUP_STAGES;
+        }
+        const WorkgroupShape wg = workgroups[static_cast<int>(TunedKernel::FftStage)];
+        pass.setPipeline(fft_h_pipeline);
+        for (unsigned s = first; s < fft_log; s++)
+            dispatch(fft_log + s, fft_size / 2 / wg.x, fft_size / wg.y, fft_layers);
+    }
+    pass.popDebugGroup();
+
+    pass.pushDebugGroup("Resolve (transposed)");
+    pass.setPipeline(fft_resolve_transposed_pipeline);
+    dispatch(0, fft_size / 16, fft_size / 16, cascades);
+    pass.popDebugGroup();
+}
+
+void OceanSim::encode_buffer_fft(wgpu::CommandEncoder encoder, bool single_dispatch)
+{
+    /* Stage slots are shared with the texture path; slot 0 carries log2n for the
+       single-dispatch kernels, which ignore stage. */
+    uint32_t off = 0;
+
+    /* timeSpectrumBuffer: scatter packed spectra to bit-reversed positions. */
+    ComputePassEncoder pass = begin_pass(encoder, "Time Spectrum");
+    pass.setBindGroup(0, buffer_bind_group, 1, &off);
+    pass.setPipeline(time_spectrum_buffer_pipeline);
+    pass.dispatchWorkgroups(fft_size / 16, fft_size / 16, cascades);
+    end_pass(pass);
+
+    pass = begin_pass(encoder, fft_scope);
+    pass.setBindGroup(0, buffer_bind_group, 1, &off);
+
+    if (single_dispatch) {
+        pass.pushDebugGroup("FFT Horizontal");
+        pass.setPipeline(fft_h_buffer_shared_pipeline);
+        pass.dispatchWorkgroups(1, fft_size, fft_layers);
+        pass.popDebugGroup();
+
+        pass.pushDebugGroup("FFT Vertical");
+        pass.setPipeline(fft_v_buffer_shared_pipeline);
+        pass.dispatchWorkgroups(fft_size, 1, fft_layers);
+        pass.popDebugGroup();
+    } else {
+        /* In-place stages: no ping-pong, just one slot offset per stage. */
+        pass.pushDebugGroup("FFT Horizontal");
+        pass.setPipeline(fft_h_buffer_pipeline);
+        for (unsigned s = 0; s < fft_log; s++) {
+            off = static_cast<uint32_t>(s) * compute_uniform_stride;
+            pass.setBindGroup(0, buffer_bind_group, 1, &off);
+            pass.dispatchWorkgroups(fft_size / 2 / 16, fft_size / 16, fft_layers);
+        }
+        pass.popDebugGroup();
+
+        pass.pushDebugGroup("FFT Vertical");
+        pass.setPipeline(fft_v_buffer_pipeline);
+        for (unsigned s = 0; s < fft_log; s++) {
+            off = static_cast<uint32_t>(s) * compute_uniform_stride;
+            pass.setBindGroup(0, buffer_bind_group, 1, &off);
+            pass.dispatchWorkgroups(fft_size / 16, fft_size / 2 / 16, fft_layers);
+        }
+        pass.popDebugGroup();
+    }
+
+    /* Materialise the spatial result as the renderer's displacement and slope textures. */
+    pass.pushDebugGroup("Resolve");
+    pass.setPipeline(resolve_buffer_pipeline);
+    pass.dispatchWorkgroups(fft_size / 16, fft_size / 16, cascades);
+    pass.popDebugGroup();
+
+    end_pass(pass);
 }
 
 // ---------------------------------------------------------------------------
 // Private: pipeline creation
 // ---------------------------------------------------------------------------
 
+namespace {
+
+/* Replacement giving the WGSL constant `name`, declared `const name: u32 = <fallback>u;`,
+   the value `value`. Sizes are specialised in the source rather than through override
+   constants, which wgpu-native 0.19 does not support. */
+std::pair<std::string, std::string> specialise(const char* name, uint32_t fallback, uint32_t value)
+{
+    const std::string decl = std::string("const ") + name + ": u32 = ";
+    return { decl + std::to_string(fallback) + "u;", decl + std::to_string(value) + "u;" };
+}
+
+} // namespace
+
 void OceanSim::init_pipelines()
 {
+    /* Single-dispatch variants hold a full line twice (ping-pong) in workgroup memory
+       and use one invocation per butterfly; fall back to the stage chain otherwise. */
+    SupportedLimits supported;
+    device.getLimits(&supported);
+    const uint32_t line_bytes = 2 * fft_size * 2 * sizeof(float);
+    shared_fft = supported.limits.maxComputeWorkgroupStorageSize   >= line_bytes
+              && supported.limits.maxComputeInvocationsPerWorkgroup >= fft_size / 2
+              && supported.limits.maxComputeWorkgroupSizeX          >= fft_size / 2;
+
+    /* Half mode swaps the storage texel format of every kernel that writes the FFT
+       arrays; the buffer backend additionally picks its element type. The single-dispatch
+       kernels are sized for N, and only when they fit: the default keeps their line
+       buffers small for the entry points that do not use them. */
+    ShaderVariant variant;
+    if (half) variant.replacements.push_back({ "rgba32float", "rgba16float" });
+    if (analytic_jacobian)
+        variant.replacements.push_back({ "const FFT_CHANNELS: u32 = 3u;", "const FFT_CHANNELS: u32 = 4u;" });
+    if (shared_fft)
+        variant.replacements.push_back(specialise("FFT_N", 256, fft_size));
+
+    ShaderVariant buffer_variant = variant;
+    buffer_variant.prelude = half_buffer ? "enable f16;\nalias StorageComplex = vec2<f16>;\n"
+                                         : "alias StorageComplex = vec2<f32>;\n";
+
     // --- time_spectrum pipeline ---
     {
-        ShaderModule ts_module = ResourceManager::load_shader_module(
-            RESOURCE_DIR "/time_spectrum.wgsl", device);
-
         std::vector<BindGroupLayoutEntry> ts_entries = {
             uniform_layout        (0, ShaderStage::Compute, false, sizeof(FourierUniforms)),
-            storage_texture_layout(1, ShaderStage::Compute),
-            texture_layout        (2, ShaderStage::Compute, TextureSampleType::UnfilterableFloat),
-            texture_layout        (3, ShaderStage::Compute, TextureSampleType::UnfilterableFloat),
-            storage_texture_layout(4, ShaderStage::Compute),
-            storage_texture_layout(5, ShaderStage::Compute),
-            storage_texture_layout(6, ShaderStage::Compute),
-            storage_texture_layout(7, ShaderStage::Compute),
+            storage_texture_layout(1, ShaderStage::Compute, storage_format, TextureViewDimension::_2DArray),
+            texture_layout        (2, ShaderStage::Compute, TextureSampleType::UnfilterableFloat, TextureViewDimension::_2DArray),
+            texture_layout        (3, ShaderStage::Compute, TextureSampleType::UnfilterableFloat, TextureViewDimension::_2DArray),
+            storage_buffer_layout (4, ShaderStage::Compute),
         };
 
         BindGroupLayoutDescriptor bgl_desc = {};
@@ -324,27 +1351,31 @@ void OceanSim::init_pipelines()
         layout_desc.bindGroupLayouts     = reinterpret_cast<WGPUBindGroupLayout*>(&time_spectrum_bgl);
         time_spectrum_layout             = device.createPipelineLayout(layout_desc);
 
-        ComputePipelineDescriptor pipe_desc;
-        pipe_desc.layout                = time_spectrum_layout;
-        pipe_desc.compute.module        = ts_module;
-        pipe_desc.compute.entryPoint    = "timeSpectrum";
-        pipe_desc.compute.constantCount = 0;
-        pipe_desc.compute.constants     = nullptr;
-        time_spectrum_pipeline = device.createComputePipeline(pipe_desc);
-
-        ts_module.release();
+        tunable_sources[static_cast<int>(TunedKernel::Spectrum)] = {
+            { RESOURCE_DIR "/spectrum_common.wgsl", RESOURCE_DIR "/time_spectrum.wgsl" }, variant };
+        create_tuned_pipelines(static_cast<int>(TunedKernel::Spectrum));
     }
 
     // --- FFT pipeline ---
     {
         ShaderModule fft_module = ResourceManager::load_shader_module(
-            RESOURCE_DIR "/fft.wgsl", device);
+            { RESOURCE_DIR "/spectrum_common.wgsl", RESOURCE_DIR "/fft.wgsl" }, device, variant);
 
+        /* 4 and 5 (h0 and k data) are only read by the fused first pass,
+           6 and 7 (displacement, slope) only written by the last one,
+           8 (band pruning table) only used by the horizontal and first vertical passes,
+           9 (phasors) only advanced by the fused first pass. */
         std::vector<BindGroupLayoutEntry> fft_entries = {
             uniform_layout        (0, ShaderStage::Compute, true, sizeof(FourierUniforms)),
-            storage_texture_layout(1, ShaderStage::Compute),
-            texture_layout        (2, ShaderStage::Compute, TextureSampleType::UnfilterableFloat),
+            storage_texture_layout(1, ShaderStage::Compute, storage_format, TextureViewDimension::_2DArray),
+            texture_layout        (2, ShaderStage::Compute, TextureSampleType::UnfilterableFloat, TextureViewDimension::_2DArray),
             texture_layout        (3, ShaderStage::Compute, TextureSampleType::UnfilterableFloat),
+            texture_layout        (4, ShaderStage::Compute, TextureSampleType::UnfilterableFloat, TextureViewDimension::_2DArray),
+            texture_layout        (5, ShaderStage::Compute, TextureSampleType::UnfilterableFloat, TextureViewDimension::_2DArray),
+            storage_texture_layout(6, ShaderStage::Compute, storage_format, TextureViewDimension::_2DArray),
+            storage_texture_layout(7, ShaderStage::Compute, storage_format, TextureViewDimension::_2DArray),
+            storage_buffer_layout (8, ShaderStage::Compute, true),
+            storage_buffer_layout (9, ShaderStage::Compute),
         };
 
         BindGroupLayoutDescriptor bgl_desc = {};
@@ -363,26 +1394,160 @@ void OceanSim::init_pipelines()
         pipe_desc.compute.constantCount = 0;
         pipe_desc.compute.constants     = nullptr;
 
-        pipe_desc.compute.entryPoint = "fft_horizontal";
-        fft_h_pipeline = device.createComputePipeline(pipe_desc);
+        /* fft_horizontal, fft_vertical and fft_horizontal_fused: tuned workgroup shape. */
+        tunable_sources[static_cast<int>(TunedKernel::FftStage)] = {
+            { RESOURCE_DIR "/spectrum_common.wgsl", RESOURCE_DIR "/fft.wgsl" }, variant };
+        create_tuned_pipelines(static_cast<int>(TunedKernel::FftStage));
+
+        pipe_desc.compute.entryPoint = "resolve_output";
+        fft_resolve_pipeline = device.createComputePipeline(pipe_desc);
+
+        pipe_desc.compute.entryPoint    = "transpose_tiles";
+        fft_transpose_pipeline          = device.createComputePipeline(pipe_desc);
+        pipe_desc.compute.entryPoint    = "resolve_output_transposed";
+        fft_resolve_transposed_pipeline = device.createComputePipeline(pipe_desc);
+
+        const char* radix_entries[3][2] = {
+            { "fft_horizontal_r2", "fft_vertical_r2" },
+            { "fft_horizontal_r4", "fft_vertical_r4" },
+            { "fft_horizontal_r8", "fft_vertical_r8" },
+        };
+        for (int i = 0; i < 3; i++) {
+            pipe_desc.compute.entryPoint = radix_entries[i][0];
+            fft_h_radix_pipelines[i]     = device.createComputePipeline(pipe_desc);
+            pipe_desc.compute.entryPoint = radix_entries[i][1];
+            fft_v_radix_pipelines[i]     = device.createComputePipeline(pipe_desc);
+        }
+
+        if (shared_fft) {
+            pipe_desc.compute.entryPoint = "fft_horizontal_shared";
+            fft_h_shared_pipeline = device.createComputePipeline(pipe_desc);
+
+            pipe_desc.compute.entryPoint = "fft_vertical_shared";
+            fft_v_shared_pipeline = device.createComputePipeline(pipe_desc);
 
-        pipe_desc.compute.entryPoint = "fft_vertical";
-        fft_v_pipeline = device.createComputePipeline(pipe_desc);
+            pipe_desc.compute.entryPoint = "fft_horizontal_fused_shared";
+            fft_h_fused_shared_pipeline = device.createComputePipeline(pipe_desc);
+        }
 
+        /* Four-step chain: N = N1·N2 with N1 <= N2 <= 64 for every supported N (<= 4096),
+           so each sub-FFT needs at most 4 KiB of workgroup memory and 128 invocations.
+           FS_M sizes the workgroup and its buffer, so each step gets its own module. */
+        four_step_m[0] = 1u << (fft_log - fft_log / 2);   /* N2 */
+        four_step_m[1] = 1u << (fft_log / 2);             /* N1 */
+        {
+            const char* four_step_entries[2][2] = {
+                { "fft_horizontal_four_step_1", "fft_horizontal_four_step_2" },
+                { "fft_vertical_four_step_1",   "fft_vertical_four_step_2"   },
+            };
+            for (int step = 0; step < 2; step++) {
+                ShaderVariant fs_variant = variant;
+                fs_variant.replacements.push_back(specialise("FS_M", 64, four_step_m[step]));
+                ShaderModule fs_module = ResourceManager::load_shader_module(
+                    { RESOURCE_DIR "/spectrum_common.wgsl", RESOURCE_DIR "/fft.wgsl" }, device, fs_variant);
+                pipe_desc.compute.module = fs_module;
+                for (int d = 0; d < 2; d++) {
+                    pipe_desc.compute.entryPoint      = four_step_entries[d][step];
+                    fft_four_step_pipelines[d][step] = device.createComputePipeline(pipe_desc);
+                }
+                fs_module.release();
+            }
+            pipe_desc.compute.module = fft_module;
+        }
+
+#ifdef WEBGPU_BACKEND_DAWN
+        /* Subgroup prologue: its own module, so the portable one never names the extension.
+           Same layout and variant. */
+        if (has_subgroups) {
+            ShaderVariant sg_variant = variant;
+            sg_variant.prelude = SUBGROUP_ENABLE + sg_variant.prelude;
+            ShaderModule sg_module = ResourceManager::load_shader_module(
+                { RESOURCE_DIR "/spectrum_common.wgsl", RESOURCE_DIR "/fft.wgsl",
+                  RESOURCE_DIR "/fft_subgroup.wgsl" }, device, sg_variant);
+
+            pipe_desc.compute.module        = sg_module;
+            pipe_desc.compute.constantCount = 0;
+            pipe_desc.compute.constants     = nullptr;
+
+            pipe_desc.compute.entryPoint  = "fft_horizontal_subgroup";
+            fft_h_subgroup_pipeline       = device.createComputePipeline(pipe_desc);
+            pipe_desc.compute.entryPoint  = "fft_vertical_subgroup";
+            fft_v_subgroup_pipeline       = device.createComputePipeline(pipe_desc);
+            pipe_desc.compute.entryPoint  = "fft_horizontal_fused_subgroup";
+            fft_h_fused_subgroup_pipeline = device.createComputePipeline(pipe_desc);
+
+            sg_module.release();
+        }
+#endif
         fft_module.release();
     }
 
-    // --- foam pipeline ---
+    // --- storage-buffer backend pipelines (one layout shared by every entry point) ---
     {
-        ShaderModule foam_module = ResourceManager::load_shader_module(
-            RESOURCE_DIR "/foam.wgsl", device);
+        ShaderModule buf_module = ResourceManager::load_shader_module(
+            { RESOURCE_DIR "/spectrum_common.wgsl", RESOURCE_DIR "/fft_buffer.wgsl" }, device, buffer_variant);
+
+        std::vector<BindGroupLayoutEntry> buf_entries = {
+            uniform_layout        (0, ShaderStage::Compute, true, sizeof(FourierUniforms)),
+            storage_buffer_layout (1, ShaderStage::Compute),
+            texture_layout        (2, ShaderStage::Compute, TextureSampleType::UnfilterableFloat, TextureViewDimension::_2DArray),
+            texture_layout        (3, ShaderStage::Compute, TextureSampleType::UnfilterableFloat, TextureViewDimension::_2DArray),
+            texture_layout        (4, ShaderStage::Compute, TextureSampleType::UnfilterableFloat),
+            storage_texture_layout(5, ShaderStage::Compute, storage_format, TextureViewDimension::_2DArray),
+            storage_texture_layout(6, ShaderStage::Compute, storage_format, TextureViewDimension::_2DArray),
+            storage_buffer_layout (7, ShaderStage::Compute),
+        };
+
+        BindGroupLayoutDescriptor bgl_desc = {};
+        bgl_desc.entryCount = static_cast<uint32_t>(buf_entries.size());
+        bgl_desc.entries    = buf_entries.data();
+        buffer_bgl          = device.createBindGroupLayout(bgl_desc);
+
+        PipelineLayoutDescriptor layout_desc = {};
+        layout_desc.bindGroupLayoutCount = 1;
+        layout_desc.bindGroupLayouts     = reinterpret_cast<WGPUBindGroupLayout*>(&buffer_bgl);
+        buffer_layout                    = device.createPipelineLayout(layout_desc);
+
+        ComputePipelineDescriptor pipe_desc;
+        pipe_desc.layout                = buffer_layout;
+        pipe_desc.compute.module        = buf_module;
+        pipe_desc.compute.constantCount = 0;
+        pipe_desc.compute.constants     = nullptr;
+
+        pipe_desc.compute.entryPoint  = "timeSpectrumBuffer";
+        time_spectrum_buffer_pipeline = device.createComputePipeline(pipe_desc);
+
+        pipe_desc.compute.entryPoint = "fft_horizontal_buffer";
+        fft_h_buffer_pipeline        = device.createComputePipeline(pipe_desc);
+
+        pipe_desc.compute.entryPoint = "fft_vertical_buffer";
+        fft_v_buffer_pipeline        = device.createComputePipeline(pipe_desc);
+
+        pipe_desc.compute.entryPoint = "resolve_buffer";
+        resolve_buffer_pipeline      = device.createComputePipeline(pipe_desc);
+
+        /* shared_fft was decided above for the texture kernels, which need twice the
+           workgroup memory of these in-place ones. */
+        if (shared_fft) {
+            pipe_desc.compute.entryPoint = "fft_horizontal_buffer_shared";
+            fft_h_buffer_shared_pipeline = device.createComputePipeline(pipe_desc);
+
+            pipe_desc.compute.entryPoint = "fft_vertical_buffer_shared";
+            fft_v_buffer_shared_pipeline = device.createComputePipeline(pipe_desc);
+        }
+
+        buf_module.release();
+    }
 
+    // --- foam pipeline ---
+    {
         std::vector<BindGroupLayoutEntry> foam_entries = {
             uniform_layout        (0, ShaderStage::Compute, false, sizeof(FoamUniforms)),
             texture_layout        (1, ShaderStage::Compute, TextureSampleType::Float),
             storage_texture_layout(2, ShaderStage::Compute, TextureFormat::R32Float),
-            texture_layout        (3, ShaderStage::Compute, TextureSampleType::UnfilterableFloat),
-            texture_layout        (4, ShaderStage::Compute, TextureSampleType::UnfilterableFloat),
+            texture_layout        (3, ShaderStage::Compute, TextureSampleType::Float, TextureViewDimension::_2DArray),
+            texture_layout        (4, ShaderStage::Compute, TextureSampleType::Float, TextureViewDimension::_2DArray),
+            sampler_layout        (5, ShaderStage::Compute),
         };
 
         BindGroupLayoutDescriptor bgl_desc = {};
@@ -395,16 +1560,276 @@ void OceanSim::init_pipelines()
         layout_desc.bindGroupLayouts     = reinterpret_cast<WGPUBindGroupLayout*>(&foam_bgl);
         foam_layout                      = device.createPipelineLayout(layout_desc);
 
+        tunable_sources[static_cast<int>(TunedKernel::Foam)] = { { RESOURCE_DIR "/foam.wgsl" }, {} };
+        create_tuned_pipelines(static_cast<int>(TunedKernel::Foam));
+    }
+
+    // --- h0 generation pipelines (spectrum.wgsl) ---
+    {
+        /* h0 follows the storage precision, k-data stays f32. */
+        ShaderVariant h0_variant;
+        if (half)
+            h0_variant.replacements.push_back({ "h0_out:    texture_storage_2d_array<rgba32float, write>",
+                                                "h0_out:    texture_storage_2d_array<rgba16float, write>" });
+        ShaderModule h0_module = ResourceManager::load_shader_module(
+            { RESOURCE_DIR "/spectrum.wgsl" }, device, h0_variant);
+
+        std::vector<BindGroupLayoutEntry> h0_entries = {
+            uniform_layout        (0, ShaderStage::Compute, false, sizeof(SpectrumUniforms)),
+            texture_layout        (1, ShaderStage::Compute, TextureSampleType::UnfilterableFloat, TextureViewDimension::_2DArray),
+            storage_texture_layout(2, ShaderStage::Compute, storage_format, TextureViewDimension::_2DArray),
+            storage_texture_layout(3, ShaderStage::Compute, TextureFormat::RGBA32Float, TextureViewDimension::_2DArray),
+            storage_buffer_layout (4, ShaderStage::Compute),
+            storage_buffer_layout (5, ShaderStage::Compute),
+        };
+
+        BindGroupLayoutDescriptor bgl_desc = {};
+        bgl_desc.entryCount = static_cast<uint32_t>(h0_entries.size());
+        bgl_desc.entries    = h0_entries.data();
+        h0_bgl              = device.createBindGroupLayout(bgl_desc);
+
+        PipelineLayoutDescriptor layout_desc = {};
+        layout_desc.bindGroupLayoutCount = 1;
+        layout_desc.bindGroupLayouts     = reinterpret_cast<WGPUBindGroupLayout*>(&h0_bgl);
+        h0_layout                        = device.createPipelineLayout(layout_desc);
+
         ComputePipelineDescriptor pipe_desc;
-        pipe_desc.layout                = foam_layout;
-        pipe_desc.compute.module        = foam_module;
-        pipe_desc.compute.entryPoint    = "computeFoam";
+        pipe_desc.layout                = h0_layout;
+        pipe_desc.compute.module        = h0_module;
         pipe_desc.compute.constantCount = 0;
         pipe_desc.compute.constants     = nullptr;
-        foam_pipeline = device.createComputePipeline(pipe_desc);
 
-        foam_module.release();
+        pipe_desc.compute.entryPoint = "measureSpectrum";
+        h0_measure_pipeline          = device.createComputePipeline(pipe_desc);
+
+        pipe_desc.compute.entryPoint = "generateSpectrum";
+        h0_generate_pipeline         = device.createComputePipeline(pipe_desc);
+
+        pipe_desc.compute.entryPoint = "listRows";
+        h0_rows_pipeline             = device.createComputePipeline(pipe_desc);
+
+        h0_module.release();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Private: workgroup autotuning
+// ---------------------------------------------------------------------------
+
+namespace {
+
+const char* const TUNED_NAMES[TUNED_KERNELS] = { "timeSpectrum", "fft_stage", "foam" };
+
+/* Entry points of each family; every one is specialised with the family's shape. */
+const std::vector<const char*> TUNED_ENTRIES[TUNED_KERNELS] = {
+    { "timeSpectrum" },
+    { "fft_horizontal", "fft_vertical", "fft_horizontal_fused" },
+    { "computeFoam", "computeFoamSpectral" },
+};
+
+/* Every candidate divides N/2 for N >= 64, so the dispatches stay exact. */
+constexpr WorkgroupShape TUNE_CANDIDATES[] = {
+    { 8, 8 }, { 16, 8 }, { 8, 16 }, { 16, 16 }, { 32, 4 }, { 32, 8 },
+};
+constexpr int TUNE_REPEATS = 8;   /* dispatches per timed pass */
+constexpr int TUNE_SAMPLES = 3;   /* timed passes per candidate; the fastest counts */
+
+} // namespace
+
+/* The variant decides the kernels' texel format and layer count, so it is part of the key. */
+std::string OceanSim::tuning_key(int kernel) const
+{
+    std::string key = TUNED_NAMES[kernel];
+    if (half) key += "/f16";
+    if (analytic_jacobian) key += "/jacobian";
+    if (cascades > 1) key += "/cascades" + std::to_string(cascades);
+    return key;
+}
+
+void OceanSim::load_workgroups()
+{
+    for (int k = 0; k < TUNED_KERNELS; k++) {
+        workgroups[k] = WorkgroupShape{};
+        tuned[k]      = tuning && tuning->lookup(tuning_key(k), fft_size, workgroups[k]);
+    }
+}
+
+std::vector<ComputePipeline> OceanSim::create_family(int kernel, WorkgroupShape shape)
+{
+    /* The shape is a workgroup size, so it is substituted in the source: one module per shape. */
+    ShaderVariant variant = tunable_sources[kernel].variant;
+    variant.replacements.push_back(specialise("WG_X", 16, shape.x));
+    variant.replacements.push_back(specialise("WG_Y", 16, shape.y));
+    ShaderModule module = ResourceManager::load_shader_module(tunable_sources[kernel].paths, device, variant);
+
+    const PipelineLayout layouts[TUNED_KERNELS] = { time_spectrum_layout, fft_layout, foam_layout };
+
+    ComputePipelineDescriptor pipe_desc;
+    pipe_desc.layout                = layouts[kernel];
+    pipe_desc.compute.module        = module;
+    pipe_desc.compute.constantCount = 0;
+    pipe_desc.compute.constants     = nullptr;
+
+    std::vector<ComputePipeline> pipelines;
+    for (const char* entry : TUNED_ENTRIES[kernel]) {
+        pipe_desc.compute.entryPoint = entry;
+        pipelines.push_back(device.createComputePipeline(pipe_desc));
+    }
+    module.release();
+    return pipelines;
+}
+
+void OceanSim::create_tuned_pipelines(int kernel)
+{
+    ComputePipeline* targets[TUNED_KERNELS][3] = {
+        { &time_spectrum_pipeline },
+        { &fft_h_pipeline, &fft_v_pipeline, &fft_h_fused_pipeline },
+        { &foam_pipeline, &foam_spectral_pipeline },
+    };
+    std::vector<ComputePipeline> pipelines = create_family(kernel, workgroups[kernel]);
+    for (size_t i = 0; i < pipelines.size(); i++) {
+        if (*targets[kernel][i]) targets[kernel][i]->release();
+        *targets[kernel][i] = pipelines[i];
+    }
+}
+
+/* One representative workload of a family, as tick() dispatches it over the full grid. */
+void OceanSim::encode_family(wgpu::ComputePassEncoder pass, int kernel,
+                             const std::vector<wgpu::ComputePipeline>& pipelines, WorkgroupShape shape)
+{
+    uint32_t off = 0;
+    switch (static_cast<TunedKernel>(kernel)) {
+    case TunedKernel::Spectrum:
+        pass.setPipeline(pipelines[0]);
+        pass.setBindGroup(0, time_spectrum_bind_group, 0, nullptr);
+        pass.dispatchWorkgroups(fft_size / shape.x, fft_size / shape.y, cascades);
+        break;
+    case TunedKernel::FftStage:
+        pass.setBindGroup(0, fft_bind_groups[1], 1, &off);
+        pass.setPipeline(pipelines[0]);
+        pass.dispatchWorkgroups(fft_size / 2 / shape.x, fft_size / shape.y, fft_layers);
+        pass.setPipeline(pipelines[1]);
+        pass.dispatchWorkgroups(fft_size / shape.x, fft_size / 2 / shape.y, fft_layers);
+        break;
+    case TunedKernel::Foam:
+        pass.setPipeline(pipelines[analytic_jacobian ? 1 : 0]);
+        pass.setBindGroup(0, foam_bind_groups[0], 0, nullptr);
+        pass.dispatchWorkgroups(fft_size / shape.x, fft_size / shape.y, 1);
+        break;
+    }
+}
+
+/* Times every candidate shape of each family without a cached one, keeps the fastest and
+   records it in the tuning cache. Runs once per adapter, variant and N; needs timestamp
+   queries, otherwise the defaults stay. The kernels' results are discarded: slot 0 of the
+   uniforms is overwritten by the first tick and the textures are rewritten every frame. */
+void OceanSim::autotune()
+{
+    if (!tuning || !device.hasFeature(FeatureName::TimestampQuery)) return;
+    if (std::all_of(std::begin(tuned), std::end(tuned), [](bool t) { return t; })) return;
+
+    SupportedLimits supported;
+    device.getLimits(&supported);
+
+    QuerySetDescriptor qs_desc;
+    qs_desc.label = "Autotune timestamps";
+    qs_desc.type  = QueryType::Timestamp;
+    qs_desc.count = 2;
+    QuerySet query_set = device.createQuerySet(qs_desc);
+
+    BufferDescriptor buf_desc;
+    buf_desc.mappedAtCreation = false;
+    buf_desc.size             = 2 * sizeof(uint64_t);
+    buf_desc.usage            = BufferUsage::QueryResolve | BufferUsage::CopySrc;
+    Buffer resolve_buffer     = device.createBuffer(buf_desc);
+    buf_desc.usage            = BufferUsage::MapRead | BufferUsage::CopyDst;
+    Buffer readback_buffer    = device.createBuffer(buf_desc);
+
+    ComputePassTimestampWrites writes;
+    writes.querySet                  = query_set;
+    writes.beginningOfPassWriteIndex = 0;
+    writes.endOfPassWriteIndex       = 1;
+
+    /* Full grid, every cascade, t = 0, no phasors. */
+    FourierUniforms cu{ 0.f, 0, fft_size, fft_log, 1, fft_size, 0.f, 0, 0, cascades, (1u << cascades) - 1, 1.f, {}, {} };
+    queue.writeBuffer(compute_uniform_buffer, 0, &cu, sizeof(FourierUniforms));
+
+    /* Nanoseconds of TUNE_REPEATS back-to-back runs, or 0 when the readback failed. */
+    auto measure = [&](int kernel, const std::vector<ComputePipeline>& pipelines, WorkgroupShape shape) {
+        CommandEncoder encoder = device.createCommandEncoder(CommandEncoderDescriptor{});
+        ComputePassDescriptor pass_desc;
+        pass_desc.label           = "Autotune";
+        pass_desc.timestampWrites = &writes;
+        ComputePassEncoder pass = encoder.beginComputePass(pass_desc);
+        for (int r = 0; r < TUNE_REPEATS; r++)
+            encode_family(pass, kernel, pipelines, shape);
+        end_pass(pass);
+        encoder.resolveQuerySet(query_set, 0, 2, resolve_buffer, 0);
+        encoder.copyBufferToBuffer(resolve_buffer, 0, readback_buffer, 0, 2 * sizeof(uint64_t));
+        CommandBuffer commands = encoder.finish(CommandBufferDescriptor{});
+        queue.submit(commands);
+#ifndef WEBGPU_BACKEND_WGPU
+        wgpuCommandBufferRelease(commands);
+        wgpuCommandEncoderRelease(encoder);
+#endif
+
+        bool     done = false;
+        uint64_t ns   = 0;
+        auto callback = readback_buffer.mapAsync(MapMode::Read, 0, 2 * sizeof(uint64_t),
+                                                 [&](BufferMapAsyncStatus status) {
+            if (status == BufferMapAsyncStatus::Success) {
+                const uint64_t* stamps = static_cast<const uint64_t*>(
+                    readback_buffer.getConstMappedRange(0, 2 * sizeof(uint64_t)));
+                if (stamps[1] > stamps[0]) ns = stamps[1] - stamps[0];
+                readback_buffer.unmap();
+            }
+            done = true;
+        });
+        wait_until(device, done);
+        return ns;
+    };
+
+    for (int k = 0; k < TUNED_KERNELS; k++) {
+        if (tuned[k]) continue;
+
+        WorkgroupShape best;
+        uint64_t       best_ns = 0;
+        for (WorkgroupShape shape : TUNE_CANDIDATES) {
+            if (shape.x * shape.y > supported.limits.maxComputeInvocationsPerWorkgroup
+                || shape.x > supported.limits.maxComputeWorkgroupSizeX
+                || shape.y > supported.limits.maxComputeWorkgroupSizeY)
+                continue;
+
+            std::vector<ComputePipeline> pipelines = create_family(k, shape);
+            measure(k, pipelines, shape);   /* warm-up: pipeline compilation, caches */
+            uint64_t ns = 0;
+            for (int s = 0; s < TUNE_SAMPLES; s++) {
+                const uint64_t sample = measure(k, pipelines, shape);
+                if (sample && (!ns || sample < ns)) ns = sample;
+            }
+            for (ComputePipeline& p : pipelines) p.release();
+
+            if (ns && (!best_ns || ns < best_ns)) {
+                best    = shape;
+                best_ns = ns;
+            }
+        }
+        if (!best_ns) continue;
+
+        workgroups[k] = best;
+        tuned[k]      = true;
+        create_tuned_pipelines(k);
+        tuning->store(tuning_key(k), fft_size, best);
+        std::cout << "OceanSim: " << tuning_key(k) << " at N=" << fft_size << " -> workgroup "
+                  << best.x << "x" << best.y << " (" << best_ns * 1e-3 / TUNE_REPEATS << " us)\n";
     }
+
+    query_set.destroy();
+    query_set.release();
+    resolve_buffer.destroy();
+    resolve_buffer.release();
+    readback_buffer.destroy();
+    readback_buffer.release();
 }
 
 // ---------------------------------------------------------------------------
@@ -418,59 +1843,126 @@ void OceanSim::init_buffers()
     BufferDescriptor buf_desc;
     buf_desc.mappedAtCreation = false;
 
-    buf_desc.size  = compute_uniform_stride * TEXTURE_LOG;
+    buf_desc.size  = compute_uniform_stride * fft_log * 2;
     buf_desc.usage = BufferUsage::CopyDst | BufferUsage::Uniform;
     compute_uniform_buffer = device.createBuffer(buf_desc);
 
     buf_desc.size  = sizeof(FoamUniforms);
     buf_desc.usage = BufferUsage::CopyDst | BufferUsage::Uniform;
     foam_uniform_buffer = device.createBuffer(buf_desc);
+
+    /* At N = 4096 the spectrum buffer can outgrow maxBufferSize. The buffer backend is then
+       unavailable and a placeholder keeps its bind group valid. */
+    SupportedLimits supported;
+    device.getLimits(&supported);
+    const uint64_t component_bytes = half_buffer ? sizeof(uint16_t) : sizeof(float);
+    const uint64_t spectrum_bytes  = static_cast<uint64_t>(fft_layers) * fft_size * fft_size * 2 * component_bytes;
+    buffer_fits = spectrum_bytes <= supported.limits.maxBufferSize
+               && spectrum_bytes <= supported.limits.maxStorageBufferBindingSize;
+    if (!buffer_fits)
+        std::cout << "OceanSim: N=" << fft_size << " spectrum buffer exceeds the device limits, "
+                  << "storage-buffer backend disabled\n";
+    buf_desc.size  = buffer_fits ? spectrum_bytes : 4 * component_bytes;
+    buf_desc.usage = BufferUsage::Storage;
+    spectrum_buffer = device.createBuffer(buf_desc);
+
+    /* A baked loop frame: every cascade's displacement and slope plus one foam layer. At
+       N = 1024 in f32 a one-cascade frame is 36 MiB, so MAX_LOOP_BYTES caps the frame count
+       well below maxTextureArrayLayers at high N. */
+    const uint64_t texel_bytes = half ? 4 * sizeof(uint16_t) : 4 * sizeof(float);
+    loop_frame_bytes = static_cast<uint64_t>(fft_size) * fft_size * (2 * cascades * texel_bytes + sizeof(float));
+    loop_limit = static_cast<uint32_t>(std::min<uint64_t>(MAX_LOOP_BYTES / loop_frame_bytes,
+                                                          supported.limits.maxTextureArrayLayers / cascades));
+    if (loop_limit < 2)
+        std::cout << "OceanSim: N=" << fft_size << " loop exceeds " << MAX_LOOP_BYTES / (1024 * 1024)
+                  << " MiB, looping mode simulates live\n";
+
+    buf_desc.size  = 2 * fft_size * sizeof(uint32_t);
+    buf_desc.usage = BufferUsage::Storage | BufferUsage::CopyDst;
+    prune_buffer = device.createBuffer(buf_desc);
+
+    /* h0 generation: uniforms, the peak / row count it reduces to, and the row count's readback. */
+    buf_desc.size  = sizeof(SpectrumUniforms);
+    buf_desc.usage = BufferUsage::CopyDst | BufferUsage::Uniform;
+    h0_uniform_buffer = device.createBuffer(buf_desc);
+
+    buf_desc.size  = 2 * sizeof(uint32_t);
+    buf_desc.usage = BufferUsage::Storage | BufferUsage::CopySrc | BufferUsage::CopyDst;
+    h0_stats_buffer = device.createBuffer(buf_desc);
+
+    buf_desc.size  = sizeof(uint32_t);
+    buf_desc.usage = BufferUsage::MapRead | BufferUsage::CopyDst;
+    rows_readback_buffer = device.createBuffer(buf_desc);
+
+    /* Likewise for the phasors of several cascades at N = 4096: incremental phase is off then. */
+    const uint64_t phasor_bytes = static_cast<uint64_t>(cascades) * fft_size * fft_size * 2 * sizeof(float);
+    phasor_fits = phasor_bytes <= supported.limits.maxBufferSize
+               && phasor_bytes <= supported.limits.maxStorageBufferBindingSize;
+    if (!phasor_fits)
+        std::cout << "OceanSim: N=" << fft_size << " phasor buffer exceeds the device limits, "
+                  << "incremental phase disabled\n";
+    buf_desc.size  = phasor_fits ? phasor_bytes : 2 * sizeof(float);
+    buf_desc.usage = BufferUsage::Storage | BufferUsage::CopyDst;
+    phasor_buffer = device.createBuffer(buf_desc);
+    phasors_live  = false;
 }
 
 // ---------------------------------------------------------------------------
 // Private: texture creation
 // ---------------------------------------------------------------------------
 
-void OceanSim::init_textures(const SimulationConfig& config)
+void OceanSim::init_textures()
 {
     using wgpu::TextureUsage, wgpu::TextureFormat;
 
     const WGPUTextureUsageFlags ping_pong_usage = TextureUsage::TextureBinding | TextureUsage::StorageBinding;
     const WGPUTextureUsageFlags upload_usage    = TextureUsage::TextureBinding | TextureUsage::CopyDst;
+    /* Uploaded by the CPU spectrum path, written by spectrum.wgsl otherwise. */
+    const WGPUTextureUsageFlags spectrum_usage  = upload_usage | TextureUsage::StorageBinding;
 
     for (int i = 0; i < 2; i++) {
-        height_textures[i]      = create_texture_2d(device, TEXTURE_SIZE, TEXTURE_SIZE,
-                                                    TextureFormat::RGBA32Float, ping_pong_usage);
-        height_texture_views[i] = create_view_2d(height_textures[i], TextureFormat::RGBA32Float);
-    }
-
-    for (int i = 0; i < 2; i++) {
-        slope_x_textures[i]      = create_texture_2d(device, TEXTURE_SIZE, TEXTURE_SIZE,
-                                                      TextureFormat::RGBA32Float, ping_pong_usage);
-        slope_x_texture_views[i] = create_view_2d(slope_x_textures[i], TextureFormat::RGBA32Float);
-        slope_y_textures[i]      = create_texture_2d(device, TEXTURE_SIZE, TEXTURE_SIZE,
-                                                      TextureFormat::RGBA32Float, ping_pong_usage);
-        slope_y_texture_views[i] = create_view_2d(slope_y_textures[i], TextureFormat::RGBA32Float);
-    }
-
-    for (int i = 0; i < 2; i++) {
-        disp_x_textures[i]      = create_texture_2d(device, TEXTURE_SIZE, TEXTURE_SIZE,
-                                                     TextureFormat::RGBA32Float, ping_pong_usage);
-        disp_x_texture_views[i] = create_view_2d(disp_x_textures[i], TextureFormat::RGBA32Float);
-        disp_y_textures[i]      = create_texture_2d(device, TEXTURE_SIZE, TEXTURE_SIZE,
-                                                     TextureFormat::RGBA32Float, ping_pong_usage);
-        disp_y_texture_views[i] = create_view_2d(disp_y_textures[i], TextureFormat::RGBA32Float);
+        fft_textures[i]      = create_texture_2d_array(device, fft_size, fft_size, fft_layers,
+                                                       storage_format, ping_pong_usage);
+        fft_texture_views[i] = create_view_2d_array(fft_textures[i], storage_format, fft_layers);
     }
 
-    /* Foam textures need CopyDst for explicit zero-fill (D3D12 storage-only textures may not zero-init). */
-    const WGPUTextureUsageFlags foam_usage =
-        TextureUsage::TextureBinding | TextureUsage::StorageBinding | TextureUsage::CopyDst;
+    /* Sampled with bilinear filtering by the renderer and the foam pass (RGBA32Float relies
+       on float32-filterable). CopySrc: compare_precision reads cascade 0 of the displacement back.
+       Layers [cascades, 2·cascades) hold the previous result of decimated cascades, copied in
+       by encode_previous_copy. */
+    const WGPUTextureUsageFlags output_usage = TextureUsage::TextureBinding | TextureUsage::StorageBinding
+                                             | TextureUsage::CopySrc | TextureUsage::CopyDst;
+    displacement_texture      = create_texture_2d_array(device, fft_size, fft_size, 2 * cascades,
+                                                        storage_format, output_usage);
+    displacement_texture_view = create_view_2d_array(displacement_texture, storage_format, 2 * cascades);
+    slope_texture             = create_texture_2d_array(device, fft_size, fft_size, 2 * cascades,
+                                                        storage_format, output_usage);
+    slope_texture_view        = create_view_2d_array(slope_texture, storage_format, 2 * cascades);
+
+    SamplerDescriptor sampler_desc;
+    sampler_desc.addressModeU  = AddressMode::Repeat;
+    sampler_desc.addressModeV  = AddressMode::Repeat;
+    sampler_desc.addressModeW  = AddressMode::Repeat;
+    sampler_desc.magFilter     = FilterMode::Linear;
+    sampler_desc.minFilter     = FilterMode::Linear;
+    sampler_desc.mipmapFilter  = MipmapFilterMode::Nearest;
+    sampler_desc.lodMinClamp   = 0.f;
+    sampler_desc.lodMaxClamp   = 1.f;
+    sampler_desc.compare       = CompareFunction::Undefined;
+    sampler_desc.maxAnisotropy = 1;
+    surface_sampler = device.createSampler(sampler_desc);
+
+    /* Foam textures need CopyDst for explicit zero-fill (D3D12 storage-only textures may not zero-init),
+       CopySrc for bake_loop. */
+    const WGPUTextureUsageFlags foam_usage = TextureUsage::TextureBinding | TextureUsage::StorageBinding
+                                           | TextureUsage::CopySrc | TextureUsage::CopyDst;
     {
-        std::vector<float> zeros(TEXTURE_SIZE * TEXTURE_SIZE, 0.f);
+        std::vector<float> zeros(fft_size * fft_size, 0.f);
         for (int i = 0; i < 2; i++) {
-            foam_textures[i]      = create_texture_2d(device, TEXTURE_SIZE, TEXTURE_SIZE,
+            foam_textures[i]      = create_texture_2d(device, fft_size, fft_size,
                                                        TextureFormat::R32Float, foam_usage);
             foam_texture_views[i] = create_view_2d(foam_textures[i], TextureFormat::R32Float);
+            foam_array_views[i]   = create_view_2d_array(foam_textures[i], TextureFormat::R32Float, 1);
 
             ImageCopyTexture dst = {};
             dst.texture  = foam_textures[i];
@@ -478,22 +1970,29 @@ void OceanSim::init_textures(const SimulationConfig& config)
             dst.origin   = { 0, 0, 0 };
             dst.aspect   = TextureAspect::All;
             TextureDataLayout layout = {};
-            layout.bytesPerRow  = TEXTURE_SIZE * sizeof(float);
-            layout.rowsPerImage = TEXTURE_SIZE;
-            Extent3D extent = { TEXTURE_SIZE, TEXTURE_SIZE, 1 };
+            layout.bytesPerRow  = fft_size * sizeof(float);
+            layout.rowsPerImage = fft_size;
+            Extent3D extent = { fft_size, fft_size, 1 };
             queue.writeTexture(dst, zeros.data(), zeros.size() * sizeof(float), layout, extent);
         }
     }
 
-    spectrum_texture      = create_texture_2d(device, TEXTURE_SIZE, TEXTURE_SIZE,
-                                              TextureFormat::RGBA32Float, upload_usage);
-    spectrum_texture_view = create_view_2d(spectrum_texture, TextureFormat::RGBA32Float);
+    /* h0 follows the storage precision; k_data stays f32 because ω·t needs the
+       mantissa for long run times. */
+    spectrum_texture      = create_texture_2d_array(device, fft_size, fft_size, cascades,
+                                                    storage_format, spectrum_usage);
+    spectrum_texture_view = create_view_2d_array(spectrum_texture, storage_format, cascades);
 
-    k_data_texture      = create_texture_2d(device, TEXTURE_SIZE, TEXTURE_SIZE,
-                                            TextureFormat::RGBA32Float, upload_usage);
-    k_data_texture_view = create_view_2d(k_data_texture, TextureFormat::RGBA32Float);
+    k_data_texture      = create_texture_2d_array(device, fft_size, fft_size, cascades,
+                                                  TextureFormat::RGBA32Float, spectrum_usage);
+    k_data_texture_view = create_view_2d_array(k_data_texture, TextureFormat::RGBA32Float, cascades);
 
-    butterfly_texture      = create_texture_2d(device, TEXTURE_SIZE / 2, TEXTURE_LOG,
+    noise_texture      = create_texture_2d_array(device, fft_size, fft_size, cascades,
+                                                 TextureFormat::RG32Float, upload_usage);
+    noise_texture_view = create_view_2d_array(noise_texture, TextureFormat::RG32Float, cascades);
+    noise_live         = false;
+
+    butterfly_texture      = create_texture_2d(device, fft_size / 2, fft_log,
                                                TextureFormat::RGBA32Float, upload_usage);
     butterfly_texture_view = create_view_2d(butterfly_texture, TextureFormat::RGBA32Float);
 
@@ -501,18 +2000,18 @@ void OceanSim::init_textures(const SimulationConfig& config)
        Each texel (x, stage) = (tw.re, tw.im, a_idx, b_idx) for DIT IFFT. */
     {
         const float pi = static_cast<float>(std::numbers::pi);
-        std::vector<float> bfly(TEXTURE_SIZE / 2 * TEXTURE_LOG * 4);
-        for (unsigned s = 0; s < TEXTURE_LOG; s++) {
+        std::vector<float> bfly(fft_size / 2 * fft_log * 4);
+        for (unsigned s = 0; s < fft_log; s++) {
             int half_span = 1 << s;
             int span      = 2 * half_span;
-            for (unsigned x = 0; x < TEXTURE_SIZE / 2; x++) {
+            for (unsigned x = 0; x < fft_size / 2; x++) {
                 int local_j = x % half_span;
                 int group   = x / half_span;
                 int a_idx   = group * span + local_j;
                 int b_idx   = a_idx + half_span;
-                int k       = local_j * (TEXTURE_SIZE / span);
-                float angle = +2.f * pi * k / TEXTURE_SIZE;
-                int   idx   = (x + s * (TEXTURE_SIZE / 2)) * 4;
+                int k       = local_j * (fft_size / span);
+                float angle = +2.f * pi * k / fft_size;
+                int   idx   = (x + s * (fft_size / 2)) * 4;
                 bfly[idx + 0] = std::cos(angle);
                 bfly[idx + 1] = std::sin(angle);
                 bfly[idx + 2] = static_cast<float>(a_idx);
@@ -525,35 +2024,283 @@ void OceanSim::init_textures(const SimulationConfig& config)
         dst.origin   = { 0, 0, 0 };
         dst.aspect   = TextureAspect::All;
         TextureDataLayout layout = {};
-        layout.bytesPerRow  = (TEXTURE_SIZE / 2) * 4 * sizeof(float);
-        layout.rowsPerImage = TEXTURE_LOG;
-        Extent3D extent = { static_cast<uint32_t>(TEXTURE_SIZE / 2), TEXTURE_LOG, 1 };
+        layout.bytesPerRow  = (fft_size / 2) * 4 * sizeof(float);
+        layout.rowsPerImage = fft_log;
+        Extent3D extent = { static_cast<uint32_t>(fft_size / 2), fft_log, 1 };
         queue.writeTexture(dst, bfly.data(), bfly.size() * sizeof(float), layout, extent);
     }
+}
 
-    upload_spectrum(config);
+void OceanSim::upload_noise(const std::vector<float>& noise, uint32_t seed)
+{
+    /* One layer per cascade, the draws the CPU path makes. Uploaded once per seed:
+       regenerating the spectrum on the GPU reuses it. */
+    ImageCopyTexture dst = {};
+    dst.texture  = noise_texture;
+    dst.mipLevel = 0;
+    dst.origin   = { 0, 0, 0 };
+    dst.aspect   = TextureAspect::All;
+    TextureDataLayout layout = {};
+    layout.bytesPerRow  = fft_size * 2 * sizeof(float);
+    layout.rowsPerImage = fft_size;
+    Extent3D extent = { fft_size, fft_size, cascades };
+    queue.writeTexture(dst, noise.data(), noise.size() * sizeof(float), layout, extent);
+    noise_seed = seed;
+    noise_live = true;
+}
+
+bool OceanSim::noise_stale(const OceanConfig& ocean) const
+{
+    return ocean.gpu_spectrum && (!noise_live || noise_seed != ocean.seed);
 }
 
 void OceanSim::upload_spectrum(const SimulationConfig& config)
 {
-    std::vector<float> spectrum, k_data;
-    generate_spectrum(config, spectrum, k_data);
+    /* Startup and rebuilds go through the on-disk cache; edits in tick do not, so a session
+       of tweaking does not leave a file per setting. The web build has no disk to keep. */
+#ifdef __EMSCRIPTEN__
+    const SpectrumCache* cache = nullptr;
+#else
+    const SpectrumCache* cache = spectrum_cache;
+#endif
+    apply_spectrum(build_spectrum(config, fft_size, cascades, half, noise_stale(config.ocean), cache));
+}
+
+void OceanSim::request_spectrum(const SimulationConfig& config)
+{
+    /* The GPU path with its noise in place is one compute pass: no worker needed. */
+    if (config.ocean.gpu_spectrum && !noise_stale(config.ocean)) {
+        upload_spectrum(config);
+        return;
+    }
+#ifdef __EMSCRIPTEN__
+    upload_spectrum(config);
+#else
+    spectrum_build = std::async(std::launch::async, build_spectrum, config, fft_size, cascades,
+                                half, noise_stale(config.ocean), nullptr);
+#endif
+}
+
+OceanSim::SpectrumBuild OceanSim::build_spectrum(const SimulationConfig& config, uint32_t size,
+                                                 uint32_t layers, bool half, bool noise,
+                                                 const SpectrumCache* cache)
+{
+    SpectrumBuild build;
+    build.config = config;
+
+    /* Cascade c spans patch_size · cascade_scale^c. Bands do not overlap: each cascade keeps
+       |k| up to half its Nyquist wavenumber π·N / (2L), where the next smaller one takes
+       over, so no wave is counted twice. Cascade 0 keeps everything up to its Nyquist, the
+       largest one everything down to k = 0. With one cascade this is the classic spectrum. */
+    const double pi = std::numbers::pi;
+    for (uint32_t c = 0; c < layers; c++)
+        build.patch[c] = config.ocean.patch_size * std::pow(config.ocean.cascade_scale, static_cast<float>(c));
+    for (uint32_t c = 0; c < layers; c++) {
+        build.k_max[c] = c == 0 ? std::numeric_limits<double>::infinity()
+                                : pi * size / (2.0 * build.patch[c]);
+        build.k_min[c] = c + 1 == layers ? 0.0 : pi * size / (2.0 * build.patch[c + 1]);
+    }
+
+    /* The GPU path has nothing on the CPU to cache once its noise is in place. */
+    const SpectrumKey key = SpectrumKey::from(config.ocean, size, layers, half);
+    if (config.ocean.gpu_spectrum && !noise)
+        cache = nullptr;
+    if (cache && cache->load(key, build))
+        return build;
+
+    if (config.ocean.gpu_spectrum) {
+        for (uint32_t c = 0; noise && c < layers; c++) {
+            const std::vector<float> layer = gaussian_noise(size, config.ocean.seed, c);
+            build.noise.insert(build.noise.end(), layer.begin(), layer.end());
+        }
+        if (cache) cache->store(key, build);
+        return build;
+    }
+
+    const size_t texels = static_cast<size_t>(size) * size;
+    build.spectrum.reserve(4 * texels * layers);
+    build.k_data.reserve(4 * texels * layers);
+    for (uint32_t c = 0; c < layers; c++) {
+        std::vector<float> cascade_spectrum, cascade_k_data;
+        generate_spectrum(config, size, c, build.patch[c], build.k_min[c], build.k_max[c],
+                          cascade_spectrum, cascade_k_data);
+        build.spectrum.insert(build.spectrum.end(), cascade_spectrum.begin(), cascade_spectrum.end());
+        build.k_data.insert(build.k_data.end(), cascade_k_data.begin(), cascade_k_data.end());
+    }
+
+    const float cutoff = config.ocean.band_pruning ? config.ocean.prune_energy : 0.f;
+    build.rows = prune_bands(build.spectrum, size, layers, cutoff, build.prune_table);
+
+    if (half) {
+        build.spectrum_half.resize(build.spectrum.size());
+        std::transform(build.spectrum.begin(), build.spectrum.end(), build.spectrum_half.begin(), float_to_half);
+        build.spectrum.clear();
+    }
+    if (cache) cache->store(key, build);
+    return build;
+}
+
+void OceanSim::apply_spectrum(const SpectrumBuild& build)
+{
+    const SimulationConfig& config = build.config;
+    std::copy(std::begin(build.patch), std::end(build.patch), cascade_patch);
+
+    pruned = config.ocean.band_pruning;
+    spectrum_uploads++;
+    if (config.ocean.gpu_spectrum) {
+        if (!build.noise.empty())
+            upload_noise(build.noise, config.ocean.seed);
+        generate_gpu_spectrum(config, build.k_min, build.k_max);
+    } else {
+        upload_cpu_spectrum(build);
+    }
+
+    /* A baked loop shows the old spectrum. */
+    spectrum_config  = config.ocean;
+    amplitude_scale  = 1.f;
+    quantised_period = config.ocean.loop ? config.ocean.loop_period : 0.f;
+    loop_baked       = false;
+
+    /* The phasors track ω per texel, so a new spectrum invalidates them. */
+    omegas.clear();
+    phasors_live = false;
+}
+
+void OceanSim::upload_cpu_spectrum(const SpectrumBuild& build)
+{
+    live_rows   = build.rows;
+    rows_wanted = false;
+    queue.writeBuffer(prune_buffer, 0, build.prune_table.data(), build.prune_table.size() * sizeof(uint32_t));
 
-    auto upload = [&](Texture tex, const std::vector<float>& data) {
+    const size_t texels = static_cast<size_t>(fft_size) * fft_size;
+    auto upload = [&](Texture tex, const void* data, size_t texel_bytes) {
         ImageCopyTexture dst = {};
         dst.texture  = tex;
         dst.mipLevel = 0;
         dst.origin   = { 0, 0, 0 };
         dst.aspect   = TextureAspect::All;
         TextureDataLayout layout = {};
-        layout.bytesPerRow  = TEXTURE_SIZE * 4 * sizeof(float);
-        layout.rowsPerImage = TEXTURE_SIZE;
-        Extent3D extent = { TEXTURE_SIZE, TEXTURE_SIZE, 1 };
-        queue.writeTexture(dst, data.data(), data.size() * sizeof(float), layout, extent);
+        layout.bytesPerRow  = static_cast<uint32_t>(fft_size * texel_bytes);
+        layout.rowsPerImage = fft_size;
+        Extent3D extent = { fft_size, fft_size, cascades };
+        queue.writeTexture(dst, data, texels * cascades * texel_bytes, layout, extent);
     };
 
-    upload(spectrum_texture, spectrum);
-    upload(k_data_texture,   k_data);
+    if (half)
+        upload(spectrum_texture, build.spectrum_half.data(), 4 * sizeof(uint16_t));
+    else
+        upload(spectrum_texture, build.spectrum.data(), 4 * sizeof(float));
+    upload(k_data_texture, build.k_data.data(), 4 * sizeof(float));
+}
+
+void OceanSim::generate_gpu_spectrum(const SimulationConfig& config, const double* k_min, const double* k_max)
+{
+    /* The JONSWAP terms that do not depend on k are evaluated once, in double, here. */
+    const OceanConfig& ocean = config.ocean;
+    const JonswapParams params = JonswapParams::from(ocean);
+
+    SpectrumUniforms su = {};
+    su.wind[0]     = static_cast<float>(ocean.wind_x);
+    su.wind[1]     = static_cast<float>(ocean.wind_y);
+    su.peak_freq   = params.peak_freq;
+    su.alpha       = params.alpha;
+    su.enhancement = params.enhancement;
+    su.omega_step  = ocean.loop ? 2.f * static_cast<float>(std::numbers::pi) / ocean.loop_period : 0.f;
+    su.cutoff      = pruned ? ocean.prune_energy : 0.f;
+    su.N           = fft_size;
+    for (uint32_t c = 0; c < cascades; c++) {
+        su.patch[c]     = cascade_patch[c];
+        su.amplitude[c] = static_cast<float>(ocean.wave_amplitude * ocean.patch_size / cascade_patch[c]);
+        su.k_min[c]     = static_cast<float>(k_min[c]);
+        su.k_max[c]     = static_cast<float>(std::min(k_max[c], static_cast<double>(std::numeric_limits<float>::max())));
+    }
+    queue.writeBuffer(h0_uniform_buffer, 0, &su, sizeof(su));
+
+    /* Peak (pruning only), then h0 + k-data + row mask, then the row list. The mask is
+       accumulated with atomicOr, so the table starts cleared. */
+    CommandEncoder encoder = device.createCommandEncoder(CommandEncoderDescriptor{});
+    encoder.clearBuffer(h0_stats_buffer, 0, h0_stats_buffer.getSize());
+    encoder.clearBuffer(prune_buffer, 0, prune_buffer.getSize());
+    {
+        ComputePassEncoder pass = begin_pass(encoder, "Spectrum generation");
+        pass.setBindGroup(0, h0_bind_group, 0, nullptr);
+        if (pruned) {
+            pass.setPipeline(h0_measure_pipeline);
+            pass.dispatchWorkgroups(fft_size / 16, fft_size / 16, cascades);
+        }
+        pass.setPipeline(h0_generate_pipeline);
+        pass.dispatchWorkgroups(fft_size / 16, fft_size / 16, cascades);
+        pass.setPipeline(h0_rows_pipeline);
+        pass.dispatchWorkgroups(1, 1, 1);
+        end_pass(pass);
+    }
+    CommandBuffer commands = encoder.finish(CommandBufferDescriptor{});
+    queue.submit(commands);
+#ifndef WEBGPU_BACKEND_WGPU
+    wgpuCommandBufferRelease(commands);
+    wgpuCommandEncoderRelease(encoder);
+#endif
+
+    /* listRows puts the empty rows after the occupied ones, so all N rows are a valid
+       dispatch until the count comes back a frame or so later. */
+    live_rows   = fft_size;
+    rows_wanted = true;
+    if (rows_idle) read_row_count();
+}
+
+void OceanSim::read_row_count()
+{
+    CommandEncoder encoder = device.createCommandEncoder(CommandEncoderDescriptor{});
+    encoder.copyBufferToBuffer(h0_stats_buffer, sizeof(uint32_t), rows_readback_buffer, 0, sizeof(uint32_t));
+    CommandBuffer commands = encoder.finish(CommandBufferDescriptor{});
+    queue.submit(commands);
+#ifndef WEBGPU_BACKEND_WGPU
+    wgpuCommandBufferRelease(commands);
+    wgpuCommandEncoderRelease(encoder);
+#endif
+
+    /* Resolved by the device polling of the main loop, like the profiler's readback. */
+    const uint32_t upload = spectrum_uploads;
+    rows_wanted   = false;
+    rows_idle     = false;
+    rows_callback = rows_readback_buffer.mapAsync(MapMode::Read, 0, sizeof(uint32_t),
+                                                  [this, upload](BufferMapAsyncStatus status) {
+        if (status == BufferMapAsyncStatus::Success) {
+            uint32_t rows = 0;
+            std::memcpy(&rows, rows_readback_buffer.getConstMappedRange(0, sizeof(uint32_t)), sizeof(uint32_t));
+            rows_readback_buffer.unmap();
+            if (upload == spectrum_uploads)
+                live_rows = rows;
+        }
+        rows_idle = true;
+    });
+}
+
+void OceanSim::seed_phasors(double time)
+{
+    /* Reduce ω·t in double before narrowing: exact for any run time, unlike the f32
+       product the classic path evaluates on the GPU. */
+    constexpr double two_pi = 2.0 * std::numbers::pi;
+    if (omegas.empty()) {
+        /* ω per texel as k_data holds it; only needed here, so not read back from the GPU path. */
+        omegas.reserve(static_cast<size_t>(fft_size) * fft_size * cascades);
+        omega_max = 0.f;
+        const int N = static_cast<int>(fft_size);
+        for (uint32_t c = 0; c < cascades; c++)
+            for (int y = 0; y < N; y++)
+                for (int x = 0; x < N; x++) {
+                    omegas.push_back(texel_wave(x, y, N, cascade_patch[c], quantised_period).omega);
+                    omega_max = std::max(omega_max, omegas.back());
+                }
+    }
+    std::vector<float> phasors(2 * omegas.size());
+    for (size_t i = 0; i < omegas.size(); i++) {
+        const double phase = std::fmod(static_cast<double>(omegas[i]) * time, two_pi);
+        phasors[2 * i + 0] = static_cast<float>(std::cos(phase));
+        phasors[2 * i + 1] = static_cast<float>(std::sin(phase));
+    }
+    queue.writeBuffer(phasor_buffer, 0, phasors.data(), phasors.size() * sizeof(float));
+    phasors_live = true;
 }
 
 // ---------------------------------------------------------------------------
@@ -564,17 +2311,16 @@ void OceanSim::init_bind_groups()
 {
     // --- time_spectrum bind group ---
     {
-        std::vector<BindGroupEntry> e(8, Default);
+        std::vector<BindGroupEntry> e(5, Default);
         e[0].binding = 0;  e[0].buffer      = compute_uniform_buffer;
                            e[0].offset       = 0;
                            e[0].size         = sizeof(FourierUniforms);
-        e[1].binding = 1;  e[1].textureView  = height_texture_views[0];
+        e[1].binding = 1;  e[1].textureView  = fft_texture_views[0];
         e[2].binding = 2;  e[2].textureView  = spectrum_texture_view;
         e[3].binding = 3;  e[3].textureView  = k_data_texture_view;
-        e[4].binding = 4;  e[4].textureView  = slope_x_texture_views[0];
-        e[5].binding = 5;  e[5].textureView  = slope_y_texture_views[0];
-        e[6].binding = 6;  e[6].textureView  = disp_x_texture_views[0];
-        e[7].binding = 7;  e[7].textureView  = disp_y_texture_views[0];
+        e[4].binding = 4;  e[4].buffer       = phasor_buffer;
+                           e[4].offset       = 0;
+                           e[4].size         = phasor_buffer.getSize();
 
         BindGroupDescriptor desc;
         desc.layout     = time_spectrum_bgl;
@@ -583,44 +2329,94 @@ void OceanSim::init_bind_groups()
         time_spectrum_bind_group = device.createBindGroup(desc);
     }
 
-    // --- FFT bind groups (5 channels, ping-pong pairs) ---
+    // --- h0 generation bind group ---
+    {
+        std::vector<BindGroupEntry> e(6, Default);
+        e[0].binding = 0;  e[0].buffer      = h0_uniform_buffer;
+                           e[0].offset       = 0;
+                           e[0].size         = sizeof(SpectrumUniforms);
+        e[1].binding = 1;  e[1].textureView  = noise_texture_view;
+        e[2].binding = 2;  e[2].textureView  = spectrum_texture_view;
+        e[3].binding = 3;  e[3].textureView  = k_data_texture_view;
+        e[4].binding = 4;  e[4].buffer       = h0_stats_buffer;
+                           e[4].offset       = 0;
+                           e[4].size         = h0_stats_buffer.getSize();
+        e[5].binding = 5;  e[5].buffer       = prune_buffer;
+                           e[5].offset       = 0;
+                           e[5].size         = prune_buffer.getSize();
+
+        BindGroupDescriptor desc;
+        desc.layout     = h0_bgl;
+        desc.entryCount = static_cast<uint32_t>(e.size());
+        desc.entries    = e.data();
+        h0_bind_group   = device.createBindGroup(desc);
+    }
+
+    // --- FFT bind groups (ping-pong pair over the channel arrays) ---
     {
-        std::vector<BindGroupEntry> e(4, Default);
+        std::vector<BindGroupEntry> e(10, Default);
         e[0].binding = 0;  e[0].buffer     = compute_uniform_buffer;
                            e[0].offset      = 0;
                            e[0].size        = sizeof(FourierUniforms);
         e[3].binding = 3;  e[3].textureView = butterfly_texture_view;
+        e[4].binding = 4;  e[4].textureView = spectrum_texture_view;
+        e[5].binding = 5;  e[5].textureView = k_data_texture_view;
+        e[6].binding = 6;  e[6].textureView = displacement_texture_view;
+        e[7].binding = 7;  e[7].textureView = slope_texture_view;
+        e[8].binding = 8;  e[8].buffer      = prune_buffer;
+                           e[8].offset      = 0;
+                           e[8].size        = prune_buffer.getSize();
+        e[9].binding = 9;  e[9].buffer      = phasor_buffer;
+                           e[9].offset      = 0;
+                           e[9].size        = phasor_buffer.getSize();
 
         BindGroupDescriptor desc;
         desc.layout     = fft_bgl;
         desc.entryCount = static_cast<uint32_t>(e.size());
         desc.entries    = e.data();
 
-        auto make_pair = [&](wgpu::TextureView* views, wgpu::BindGroup* groups) {
-            e[1].binding = 1;  e[1].textureView = views[0];
-            e[2].binding = 2;  e[2].textureView = views[1];
-            groups[0] = device.createBindGroup(desc);
+        /* [i]: writes fft[i], reads fft[1-i]. */
+        for (int i = 0; i < 2; i++) {
+            e[1].binding = 1;  e[1].textureView = fft_texture_views[i];
+            e[2].binding = 2;  e[2].textureView = fft_texture_views[1 - i];
+            fft_bind_groups[i] = device.createBindGroup(desc);
+        }
+    }
 
-            e[1].textureView = views[1];
-            e[2].textureView = views[0];
-            groups[1] = device.createBindGroup(desc);
-        };
+    // --- storage-buffer backend bind group (resolves into the displacement / slope textures) ---
+    {
+        std::vector<BindGroupEntry> e(8, Default);
+        e[0].binding = 0;  e[0].buffer      = compute_uniform_buffer;
+                           e[0].offset       = 0;
+                           e[0].size         = sizeof(FourierUniforms);
+        e[1].binding = 1;  e[1].buffer      = spectrum_buffer;
+                           e[1].offset       = 0;
+                           e[1].size         = spectrum_buffer.getSize();
+        e[2].binding = 2;  e[2].textureView  = spectrum_texture_view;
+        e[3].binding = 3;  e[3].textureView  = k_data_texture_view;
+        e[4].binding = 4;  e[4].textureView  = butterfly_texture_view;
+        e[5].binding = 5;  e[5].textureView  = displacement_texture_view;
+        e[6].binding = 6;  e[6].textureView  = slope_texture_view;
+        e[7].binding = 7;  e[7].buffer       = phasor_buffer;
+                           e[7].offset       = 0;
+                           e[7].size         = phasor_buffer.getSize();
 
-        make_pair(height_texture_views,  h_fft_bind_groups);
-        make_pair(slope_x_texture_views, sx_fft_bind_groups);
-        make_pair(slope_y_texture_views, sy_fft_bind_groups);
-        make_pair(disp_x_texture_views,  dx_fft_bind_groups);
-        make_pair(disp_y_texture_views,  dy_fft_bind_groups);
+        BindGroupDescriptor desc;
+        desc.layout     = buffer_bgl;
+        desc.entryCount = static_cast<uint32_t>(e.size());
+        desc.entries    = e.data();
+        buffer_bind_group = device.createBindGroup(desc);
     }
 
     // --- foam bind groups ([i]: reads foam[i], writes foam[1-i]) ---
     {
-        std::vector<BindGroupEntry> e(5, Default);
+        std::vector<BindGroupEntry> e(6, Default);
         e[0].binding = 0;  e[0].buffer      = foam_uniform_buffer;
                            e[0].offset       = 0;
                            e[0].size         = sizeof(FoamUniforms);
-        e[3].binding = 3;  e[3].textureView  = disp_x_texture_views[0];
-        e[4].binding = 4;  e[4].textureView  = disp_y_texture_views[0];
+        e[3].binding = 3;  e[3].textureView  = displacement_texture_view;
+        e[4].binding = 4;  e[4].textureView  = slope_texture_view;
+        e[5].binding = 5;  e[5].sampler      = surface_sampler;
 
         BindGroupDescriptor desc;
         desc.layout     = foam_bgl;
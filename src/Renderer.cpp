@@ -45,7 +45,7 @@ Renderer::~Renderer()
 // ---------------------------------------------------------------------------
 
 void Renderer::init(wgpu::Device d, wgpu::Queue q, wgpu::TextureFormat fmt,
-                    uint32_t w, uint32_t h, const SimulationConfig& /*config*/)
+                    uint32_t w, uint32_t h, const SimulationConfig& config)
 {
     device         = d;
     queue          = q;
@@ -54,7 +54,7 @@ void Renderer::init(wgpu::Device d, wgpu::Queue q, wgpu::TextureFormat fmt,
     height         = h;
 
     init_pipelines();
-    init_geometry();
+    init_geometry(std::min(config.ocean.fft_size, MAX_MESH_SIZE));
     init_depth();
     init_sampler();
     init_foam_detail();
@@ -66,23 +66,29 @@ void Renderer::init(wgpu::Device d, wgpu::Queue q, wgpu::TextureFormat fmt,
     uniform_buffer = device.createBuffer(buf_desc);
 }
 
+void Renderer::rebuild_mesh(uint32_t size)
+{
+    vertex_buffer.destroy();
+    vertex_buffer.release();
+    index_buffer.destroy();
+    index_buffer.release();
+    init_geometry(size);
+}
+
 void Renderer::rebuild_bind_group(const OceanSim& ocean, int foam_idx)
 {
     if (bind_group) bind_group.release();
 
-    std::vector<BindGroupEntry> entries(10, Default);
+    std::vector<BindGroupEntry> entries(7, Default);
     entries[0].binding = 0;  entries[0].buffer      = uniform_buffer;
                               entries[0].offset       = 0;
                               entries[0].size         = sizeof(RenderUniforms);
-    entries[1].binding = 1;  entries[1].textureView  = ocean.height_view();
+    entries[1].binding = 1;  entries[1].textureView  = ocean.displacement_view();
     entries[2].binding = 2;  entries[2].sampler      = sampler;
     entries[3].binding = 3;  entries[3].textureView  = cubemap_texture_view;
-    entries[4].binding = 4;  entries[4].textureView  = ocean.slope_x_view();
-    entries[5].binding = 5;  entries[5].textureView  = ocean.slope_y_view();
-    entries[6].binding = 6;  entries[6].textureView  = ocean.disp_x_view();
-    entries[7].binding = 7;  entries[7].textureView  = ocean.disp_y_view();
-    entries[8].binding = 8;  entries[8].textureView  = ocean.foam_view(foam_idx);
-    entries[9].binding = 9;  entries[9].textureView  = foam_detail_texture_view;
+    entries[4].binding = 4;  entries[4].textureView  = ocean.foam_view(foam_idx);
+    entries[5].binding = 5;  entries[5].textureView  = foam_detail_texture_view;
+    entries[6].binding = 6;  entries[6].textureView  = ocean.slope_view();
 
     BindGroupDescriptor desc;
     desc.layout     = bind_group_layout;
@@ -198,15 +204,12 @@ void Renderer::init_pipelines()
     // --- bind group layout (shared by both render pipelines) ---
     std::vector<BindGroupLayoutEntry> entries = {
         uniform_layout (0, ShaderStage::Vertex | ShaderStage::Fragment, false, sizeof(RenderUniforms)),
-        texture_layout (1, ShaderStage::Vertex | ShaderStage::Fragment),
-        sampler_layout (2, ShaderStage::Fragment),
+        texture_layout (1, ShaderStage::Vertex,   TextureSampleType::Float, TextureViewDimension::_2DArray),
+        sampler_layout (2, ShaderStage::Vertex | ShaderStage::Fragment),
         texture_layout (3, ShaderStage::Fragment, TextureSampleType::Float, TextureViewDimension::Cube),
-        texture_layout (4, ShaderStage::Vertex,   TextureSampleType::UnfilterableFloat),
-        texture_layout (5, ShaderStage::Vertex,   TextureSampleType::UnfilterableFloat),
-        texture_layout (6, ShaderStage::Vertex,   TextureSampleType::UnfilterableFloat),
-        texture_layout (7, ShaderStage::Vertex,   TextureSampleType::UnfilterableFloat),
-        texture_layout (8, ShaderStage::Fragment, TextureSampleType::Float),
-        texture_layout (9, ShaderStage::Fragment, TextureSampleType::Float),
+        texture_layout (4, ShaderStage::Fragment, TextureSampleType::Float, TextureViewDimension::_2DArray),
+        texture_layout (5, ShaderStage::Fragment, TextureSampleType::Float),
+        texture_layout (6, ShaderStage::Fragment, TextureSampleType::Float, TextureViewDimension::_2DArray),
     };
 
     BindGroupLayoutDescriptor bgl_desc = {};
@@ -322,9 +325,9 @@ void Renderer::init_pipelines()
 // Private: geometry
 // ---------------------------------------------------------------------------
 
-void Renderer::init_geometry()
+void Renderer::init_geometry(uint32_t mesh_size)
 {
-    const int size = static_cast<int>(MESH_SIZE);
+    const int size = static_cast<int>(mesh_size);
     std::vector<float>    vertices;
     std::vector<uint32_t> indices;
     vertices.reserve(static_cast<size_t>(size * size * 5));
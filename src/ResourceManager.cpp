@@ -24,16 +24,52 @@ using namespace wgpu;
 
 wgpu::ShaderModule ResourceManager::load_shader_module(
     const std::filesystem::path& path, Device device)
+{
+    std::string source;
+    if (!read_text(path, source)) return nullptr;
+    return create_shader_module(source, device);
+}
+
+wgpu::ShaderModule ResourceManager::load_shader_module(
+    const std::vector<std::filesystem::path>& paths, Device device)
+{
+    return load_shader_module(paths, device, ShaderVariant{});
+}
+
+wgpu::ShaderModule ResourceManager::load_shader_module(
+    const std::vector<std::filesystem::path>& paths, Device device, const ShaderVariant& variant)
+{
+    std::string source = variant.prelude;
+    for (const auto& path : paths) {
+        std::string part;
+        if (!read_text(path, part)) return nullptr;
+        source += part;
+        source += '\n';
+    }
+
+    for (const auto& [from, to] : variant.replacements) {
+        if (from.empty()) continue;
+        for (size_t pos = source.find(from); pos != std::string::npos; pos = source.find(from, pos + to.size()))
+            source.replace(pos, from.size(), to);
+    }
+    return create_shader_module(source, device);
+}
+
+bool ResourceManager::read_text(const std::filesystem::path& path, std::string& out)
 {
     std::ifstream file(path);
-    if (!file.is_open()) return nullptr;
+    if (!file.is_open()) return false;
 
     file.seekg(0, std::ios::end);
     size_t size = file.tellg();
-    std::string source(size, ' ');
+    out.assign(size, ' ');
     file.seekg(0);
-    file.read(source.data(), size);
+    file.read(out.data(), size);
+    return true;
+}
 
+wgpu::ShaderModule ResourceManager::create_shader_module(const std::string& source, Device device)
+{
     ShaderModuleWGSLDescriptor wgsl_desc{};
     wgsl_desc.chain.next  = nullptr;
     wgsl_desc.chain.sType = SType::ShaderModuleWGSLDescriptor;
@@ -0,0 +1,167 @@
+#include "SpectrumCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+
+namespace {
+
+/* Bump when generate_spectrum, prune_bands or the Gaussian draws change their output. */
+constexpr uint32_t SPECTRUM_CACHE_VERSION = 1;
+
+constexpr char MAGIC[8] = { 'O', 'C', 'E', 'A', 'N', 'H', '0', '\0' };
+
+struct FileHeader {
+    char        magic[8];
+    SpectrumKey key;
+    uint64_t    lengths[5];   /* elements of noise, spectrum, spectrum_half, k_data, prune_table */
+    uint32_t    rows;
+    uint32_t    reserved;
+};
+
+/* Array lengths a spectrum of `key` has, in FileHeader::lengths order. */
+void expected_lengths(const SpectrumKey& key, uint64_t lengths[5])
+{
+    const uint64_t texels = static_cast<uint64_t>(key.size) * key.size * key.layers;
+    lengths[0] = key.gpu_spectrum ? 2 * texels : 0;
+    lengths[1] = !key.gpu_spectrum && !key.half ? 4 * texels : 0;
+    lengths[2] = !key.gpu_spectrum && key.half ? 4 * texels : 0;
+    lengths[3] = key.gpu_spectrum ? 0 : 4 * texels;
+    lengths[4] = key.gpu_spectrum ? 0 : 2 * static_cast<uint64_t>(key.size);
+}
+
+template <typename T>
+bool read_array(std::ifstream& in, std::vector<T>& v, uint64_t length)
+{
+    v.resize(length);
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(v.data()), static_cast<std::streamsize>(length * sizeof(T))));
+}
+
+template <typename T>
+void write_array(std::ofstream& out, const std::vector<T>& v)
+{
+    out.write(reinterpret_cast<const char*>(v.data()), static_cast<std::streamsize>(v.size() * sizeof(T)));
+}
+
+} // namespace
+
+SpectrumKey SpectrumKey::from(const OceanConfig& ocean, uint32_t size, uint32_t layers, bool half)
+{
+    SpectrumKey key;
+    key.version      = SPECTRUM_CACHE_VERSION;
+    key.size         = size;
+    key.layers       = layers;
+    key.seed         = ocean.seed;
+    key.gpu_spectrum = ocean.gpu_spectrum;
+    if (ocean.gpu_spectrum)
+        return key;
+
+    key.wave_amplitude = ocean.wave_amplitude;
+    key.fetch          = ocean.fetch;
+    key.wind_x         = ocean.wind_x;
+    key.wind_y         = ocean.wind_y;
+    key.enhancement    = ocean.enhancement;
+    key.patch_size     = ocean.patch_size;
+    key.cascade_scale  = layers > 1 ? ocean.cascade_scale : 0.f;
+    key.half           = half;
+    key.band_pruning   = ocean.band_pruning;
+    key.prune_energy   = ocean.band_pruning ? ocean.prune_energy : 0.f;
+    key.loop           = ocean.loop;
+    key.loop_period    = ocean.loop ? ocean.loop_period : 0.f;
+    return key;
+}
+
+uint64_t SpectrumKey::hash() const
+{
+    /* FNV-1a over the raw bytes. */
+    unsigned char bytes[sizeof(SpectrumKey)];
+    std::memcpy(bytes, this, sizeof(SpectrumKey));
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (unsigned char b : bytes) {
+        h ^= b;
+        h *= 0x100000001B3ull;
+    }
+    return h;
+}
+
+std::filesystem::path SpectrumCache::file(const SpectrumKey& key) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.h0", static_cast<unsigned long long>(key.hash()));
+    return dir / name;
+}
+
+bool SpectrumCache::load(const SpectrumKey& key, SpectrumData& data) const
+{
+    std::ifstream in(file(key), std::ios::binary);
+    if (!in.is_open()) return false;
+
+    FileHeader header = {};
+    uint64_t   lengths[5];
+    expected_lengths(key, lengths);
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0
+        || std::memcmp(&header.key, &key, sizeof(SpectrumKey)) != 0
+        || std::memcmp(header.lengths, lengths, sizeof(lengths)) != 0)
+        return false;
+
+    /* rows sizes the pruned dispatch: the CPU path keeps 1..N rows, the GPU path none. */
+    const bool rows_valid = key.gpu_spectrum ? header.rows == 0 : header.rows >= 1 && header.rows <= key.size;
+    if (!rows_valid) return false;
+
+    SpectrumData cached;
+    cached.rows = header.rows;
+    if (!read_array(in, cached.noise, lengths[0]) || !read_array(in, cached.spectrum, lengths[1])
+        || !read_array(in, cached.spectrum_half, lengths[2]) || !read_array(in, cached.k_data, lengths[3])
+        || !read_array(in, cached.prune_table, lengths[4]))
+        return false;
+    /* Bytes past the last array mean the file is not the one the header describes. */
+    if (in.peek() != std::ifstream::traits_type::eof())
+        return false;
+
+    data = std::move(cached);
+    return true;
+}
+
+void SpectrumCache::store(const SpectrumKey& key, const SpectrumData& data) const
+{
+    FileHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.key        = key;
+    header.lengths[0] = data.noise.size();
+    header.lengths[1] = data.spectrum.size();
+    header.lengths[2] = data.spectrum_half.size();
+    header.lengths[3] = data.k_data.size();
+    header.lengths[4] = data.prune_table.size();
+    header.rows       = data.rows;
+
+    std::error_code error;
+    std::filesystem::create_directories(dir, error);
+    const std::filesystem::path target = file(key);
+    std::filesystem::path       temp   = target;
+    temp += ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "SpectrumCache: cannot write " << temp.string() << '\n';
+            return;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        write_array(out, data.noise);
+        write_array(out, data.spectrum);
+        write_array(out, data.spectrum_half);
+        write_array(out, data.k_data);
+        write_array(out, data.prune_table);
+        if (!out) {
+            std::cerr << "SpectrumCache: cannot write " << temp.string() << '\n';
+            out.close();
+            std::filesystem::remove(temp, error);
+            return;
+        }
+    }
+    std::filesystem::rename(temp, target, error);
+    if (error)
+        std::cerr << "SpectrumCache: cannot write " << target.string() << '\n';
+}
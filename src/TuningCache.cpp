@@ -0,0 +1,71 @@
+#include "TuningCache.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+void TuningCache::init(const std::string& key, const std::filesystem::path& path)
+{
+    /* Tabs and newlines are the file's separators. */
+    adapter_key = key;
+    std::replace_if(adapter_key.begin(), adapter_key.end(),
+                    [](char c) { return c == '\t' || c == '\n' || c == '\r'; }, ' ');
+    file = path;
+    entries.clear();
+
+    std::ifstream in(file);
+    if (!in.is_open()) return;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        Entry e;
+        std::string n, x, y;
+        if (!std::getline(fields, e.adapter, '\t') || !std::getline(fields, e.kernel, '\t')
+            || !std::getline(fields, n, '\t') || !std::getline(fields, x, '\t') || !std::getline(fields, y))
+            continue;
+        try {
+            e.n       = static_cast<uint32_t>(std::stoul(n));
+            e.shape.x = static_cast<uint32_t>(std::stoul(x));
+            e.shape.y = static_cast<uint32_t>(std::stoul(y));
+        } catch (const std::exception&) {
+            continue;
+        }
+        entries.push_back(e);
+    }
+}
+
+bool TuningCache::lookup(const std::string& kernel, uint32_t n, WorkgroupShape& shape) const
+{
+    for (const Entry& e : entries) {
+        if (e.adapter == adapter_key && e.kernel == kernel && e.n == n) {
+            shape = e.shape;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TuningCache::store(const std::string& kernel, uint32_t n, WorkgroupShape shape)
+{
+    auto it = std::find_if(entries.begin(), entries.end(), [&](const Entry& e) {
+        return e.adapter == adapter_key && e.kernel == kernel && e.n == n;
+    });
+    if (it != entries.end())
+        it->shape = shape;
+    else
+        entries.push_back({ adapter_key, kernel, n, shape });
+    save();
+}
+
+void TuningCache::save() const
+{
+    std::ofstream out(file, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "TuningCache: cannot write " << file.string() << '\n';
+        return;
+    }
+    for (const Entry& e : entries)
+        out << e.adapter << '\t' << e.kernel << '\t' << e.n << '\t' << e.shape.x << '\t' << e.shape.y << '\n';
+}